@@ -0,0 +1,93 @@
+#pragma once
+#include "State.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+// The last ACTION_HISTORY actions of one fighter, in a fixed ring with
+// per-action counts kept up to date on every push.
+//
+// The network input block (ACTION_HISTORY_FEATURES floats) is maintained
+// alongside: a one-hot row for each of the ENCODED_RECENT_ACTIONS newest
+// actions, newest first, followed by every action's share of the history.
+// push() touches a constant number of floats, and encode() is a copy.
+class ActionHistory {
+public:
+  static constexpr size_t CAPACITY = ACTION_HISTORY;
+
+  void push(ActionType action) {
+    const int index = static_cast<int>(action);
+    if (m_size == CAPACITY) {
+      --m_counts[static_cast<int>(m_actions[m_head])];
+    } else {
+      ++m_size;
+    }
+    m_actions[m_head] = action;
+    m_head = (m_head + 1) % CAPACITY;
+    ++m_counts[index];
+
+    // Shift the recent one-hot rows down by one and put `action` on top.
+    float *recent = m_encoding.data();
+    std::copy_backward(recent, recent + RECENT_FLOATS - ACTION_COUNT,
+                       recent + RECENT_FLOATS);
+    std::fill(recent, recent + ACTION_COUNT, 0.0f);
+    recent[index] = 1.0f;
+
+    float *shares = m_encoding.data() + RECENT_FLOATS;
+    for (int a = 0; a < ACTION_COUNT; ++a)
+      shares[a] = static_cast<float>(m_counts[a]) / CAPACITY;
+  }
+
+  void clear() {
+    m_head = 0;
+    m_size = 0;
+    m_counts.fill(0);
+    m_encoding.fill(0.0f);
+  }
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  bool full() const { return m_size == CAPACITY; }
+
+  // Oldest first, like the deque this replaces.
+  ActionType operator[](size_t i) const {
+    return m_actions[(m_head + CAPACITY - m_size + i) % CAPACITY];
+  }
+  // `age` 0 is the newest action; Noop past the start of the history.
+  ActionType recent(size_t age = 0) const {
+    if (age >= m_size)
+      return ActionType::Noop;
+    return m_actions[(m_head + CAPACITY - 1 - age) % CAPACITY];
+  }
+  ActionType front() const { return (*this)[0]; }
+  ActionType back() const { return recent(0); }
+
+  int count(ActionType action) const {
+    return m_counts[static_cast<int>(action)];
+  }
+  // Ties go to the lower ActionType.
+  ActionType mostFrequent() const {
+    int best = 0;
+    for (int a = 1; a < ACTION_COUNT; ++a)
+      if (m_counts[a] > m_counts[best])
+        best = a;
+    return static_cast<ActionType>(best);
+  }
+  bool allSame() const {
+    return m_size > 0 && count(back()) == static_cast<int>(m_size);
+  }
+
+  void encode(float *out) const {
+    std::copy(m_encoding.begin(), m_encoding.end(), out);
+  }
+
+private:
+  static constexpr size_t RECENT_FLOATS =
+      ENCODED_RECENT_ACTIONS * ACTION_COUNT;
+
+  std::array<ActionType, CAPACITY> m_actions{};
+  size_t m_head = 0;
+  size_t m_size = 0;
+  std::array<int, ACTION_COUNT> m_counts{};
+  std::array<float, ACTION_HISTORY_FEATURES> m_encoding{};
+};
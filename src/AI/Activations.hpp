@@ -0,0 +1,276 @@
+#pragma once
+#include "Kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// Stored as an int in exported models, so new types must be appended.
+enum class ActivationType { None, ReLU, Sigmoid, Tanh, LeakyReLU, GELU };
+
+inline const char *activationTypeToString(ActivationType act) {
+  switch (act) {
+  case ActivationType::ReLU:
+    return "ReLU";
+  case ActivationType::Sigmoid:
+    return "Sigmoid";
+  case ActivationType::Tanh:
+    return "Tanh";
+  case ActivationType::LeakyReLU:
+    return "LeakyReLU";
+  case ActivationType::GELU:
+    return "GELU";
+  case ActivationType::None:
+  default:
+    return "None";
+  }
+}
+
+constexpr float LEAKY_RELU_SLOPE = 0.01f;
+
+// Fast mode evaluates sigmoid/tanh/GELU with a rational approximation in the
+// buffer kernels below. Max absolute error against the libm reference,
+// measured over [-20, 20] in steps of 1e-4:
+//
+//   tanh     3.0e-7
+//   sigmoid  2.4e-7
+//   GELU     4.7e-4 vs the erf definition, 8.7e-7 vs the tanh form it
+//            implements (derivative: 8.7e-4 vs erf)
+//
+// Exact mode uses std::exp / std::tanh / std::erf per element. ReLU and
+// LeakyReLU are exact in both modes.
+enum class ActivationPrecision { Fast, Exact };
+
+inline ActivationPrecision &activationPrecisionSetting() {
+  static ActivationPrecision precision = ActivationPrecision::Fast;
+  return precision;
+}
+inline ActivationPrecision activationPrecision() {
+  return activationPrecisionSetting();
+}
+inline void setActivationPrecision(ActivationPrecision precision) {
+  activationPrecisionSetting() = precision;
+}
+
+namespace activation_detail {
+constexpr float GELU_SCALE = 0.7978845608f; // sqrt(2 / pi)
+constexpr float GELU_CUBIC = 0.044715f;
+
+// Minimax rational approximation (degree 13/6) of tanh on [-7.9, 7.9]; tanh
+// rounds to +-1 in float beyond that, so inputs are simply clamped.
+template <typename V> inline V fastTanh(V x) {
+  using simd::splat;
+  x = simd::min(simd::max(x, splat<V>(-7.90531110763549805f)),
+                splat<V>(7.90531110763549805f));
+  V x2 = x * x;
+  V p = splat<V>(-2.76076847742355e-16f);
+  p = p * x2 + splat<V>(2.00018790482477e-13f);
+  p = p * x2 + splat<V>(-8.60467152213735e-11f);
+  p = p * x2 + splat<V>(5.12229709037114e-08f);
+  p = p * x2 + splat<V>(1.48572235717979e-05f);
+  p = p * x2 + splat<V>(6.37261928875436e-04f);
+  p = p * x2 + splat<V>(4.89352455891786e-03f);
+  p = p * x;
+  V q = splat<V>(1.19825839466702e-06f);
+  q = q * x2 + splat<V>(1.18534705686654e-04f);
+  q = q * x2 + splat<V>(2.26843463243900e-03f);
+  q = q * x2 + splat<V>(4.89352518554385e-03f);
+  return p / q;
+}
+
+template <typename V> inline V fastSigmoid(V x) {
+  using simd::splat;
+  return splat<V>(0.5f) + splat<V>(0.5f) * fastTanh(splat<V>(0.5f) * x);
+}
+
+template <typename V> inline V geluInner(V x) {
+  using simd::splat;
+  return splat<V>(GELU_SCALE) * (x + splat<V>(GELU_CUBIC) * x * x * x);
+}
+
+template <typename V> inline V fastGelu(V x) {
+  using simd::splat;
+  return splat<V>(0.5f) * x * (splat<V>(1.0f) + fastTanh(geluInner(x)));
+}
+
+template <typename V> inline V fastGeluDerivative(V x) {
+  using simd::splat;
+  V t = fastTanh(geluInner(x));
+  V dInner = splat<V>(GELU_SCALE) *
+             (splat<V>(1.0f) + splat<V>(3.0f * GELU_CUBIC) * x * x);
+  return splat<V>(0.5f) * (splat<V>(1.0f) + t) +
+         splat<V>(0.5f) * x * (splat<V>(1.0f) - t * t) * dInner;
+}
+
+inline float exactGelu(float x) {
+  return 0.5f * x * (1.0f + std::erf(x * 0.70710678f));
+}
+
+inline float exactGeluDerivative(float x) {
+  float cdf = 0.5f * (1.0f + std::erf(x * 0.70710678f));
+  float pdf = 0.39894228f * std::exp(-0.5f * x * x);
+  return cdf + x * pdf;
+}
+} // namespace activation_detail
+
+// Scalar reference implementations (always exact).
+inline float activate(float x, ActivationType act) {
+  switch (act) {
+  case ActivationType::ReLU:
+    return x > 0 ? x : 0;
+  case ActivationType::Sigmoid:
+    return 1.0f / (1.0f + std::exp(-x));
+  case ActivationType::Tanh:
+    return std::tanh(x);
+  case ActivationType::LeakyReLU:
+    return x > 0 ? x : LEAKY_RELU_SLOPE * x;
+  case ActivationType::GELU:
+    return activation_detail::exactGelu(x);
+  case ActivationType::None:
+  default:
+    return x;
+  }
+}
+
+inline float activateDerivative(float x, ActivationType act) {
+  switch (act) {
+  case ActivationType::ReLU:
+    return x > 0 ? 1.0f : 0.0f;
+  case ActivationType::Sigmoid: {
+    float sig = 1.0f / (1.0f + std::exp(-x));
+    return sig * (1 - sig);
+  }
+  case ActivationType::Tanh: {
+    float t = std::tanh(x);
+    return 1.0f - t * t;
+  }
+  case ActivationType::LeakyReLU:
+    return x > 0 ? 1.0f : LEAKY_RELU_SLOPE;
+  case ActivationType::GELU:
+    return activation_detail::exactGeluDerivative(x);
+  case ActivationType::None:
+  default:
+    return 1.0f;
+  }
+}
+
+// y[i] = f(z[i]) over a whole layer. `y` may alias `z`.
+inline void activateBuffer(const float *z, float *y, size_t n,
+                           ActivationType act) {
+  using namespace activation_detail;
+  using simd::loadAs;
+  using simd::splat;
+  using simd::store;
+
+  switch (act) {
+  case ActivationType::None:
+    if (y != z)
+      std::copy(z, z + n, y);
+    return;
+  case ActivationType::ReLU:
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      store(y + i, simd::max(loadAs<V>(z + i), splat<V>(0.0f)));
+    });
+    return;
+  case ActivationType::LeakyReLU:
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      V x = loadAs<V>(z + i);
+      store(y + i, simd::max(x, splat<V>(0.0f)) +
+                       splat<V>(LEAKY_RELU_SLOPE) *
+                           simd::min(x, splat<V>(0.0f)));
+    });
+    return;
+  default:
+    break;
+  }
+
+  if (activationPrecision() == ActivationPrecision::Exact) {
+    for (size_t i = 0; i < n; ++i)
+      y[i] = activate(z[i], act);
+    return;
+  }
+
+  switch (act) {
+  case ActivationType::Sigmoid:
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      store(y + i, fastSigmoid(loadAs<V>(z + i)));
+    });
+    return;
+  case ActivationType::Tanh:
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      store(y + i, fastTanh(loadAs<V>(z + i)));
+    });
+    return;
+  case ActivationType::GELU:
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      store(y + i, fastGelu(loadAs<V>(z + i)));
+    });
+    return;
+  default:
+    return;
+  }
+}
+
+// delta[i] *= f'(z[i]). Sigmoid, tanh and the ReLU family take the
+// derivative from the cached outputs `y`; only GELU needs the
+// pre-activations `z`.
+inline void activationBackward(float *delta, const float *z, const float *y,
+                               size_t n, ActivationType act) {
+  using namespace activation_detail;
+  using simd::loadAs;
+  using simd::splat;
+  using simd::store;
+
+  switch (act) {
+  case ActivationType::None:
+    return;
+  case ActivationType::ReLU:
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      V mask = simd::positive(loadAs<V>(y + i));
+      store(delta + i, loadAs<V>(delta + i) * mask);
+    });
+    return;
+  case ActivationType::LeakyReLU:
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      V slope = splat<V>(LEAKY_RELU_SLOPE) +
+                splat<V>(1.0f - LEAKY_RELU_SLOPE) *
+                    simd::positive(loadAs<V>(y + i));
+      store(delta + i, loadAs<V>(delta + i) * slope);
+    });
+    return;
+  case ActivationType::Sigmoid:
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      V out = loadAs<V>(y + i);
+      store(delta + i,
+            loadAs<V>(delta + i) * out * (splat<V>(1.0f) - out));
+    });
+    return;
+  case ActivationType::Tanh:
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      V out = loadAs<V>(y + i);
+      store(delta + i,
+            loadAs<V>(delta + i) * (splat<V>(1.0f) - out * out));
+    });
+    return;
+  case ActivationType::GELU:
+    if (activationPrecision() == ActivationPrecision::Exact) {
+      for (size_t i = 0; i < n; ++i)
+        delta[i] *= exactGeluDerivative(z[i]);
+      return;
+    }
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      store(delta + i,
+            loadAs<V>(delta + i) * fastGeluDerivative(loadAs<V>(z + i)));
+    });
+    return;
+  }
+}
@@ -0,0 +1,474 @@
+#include "Checkpoint.hpp"
+#include "Core/Logger.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CHECKPOINT_MMAP 1
+#endif
+
+namespace {
+constexpr char MAGIC[8] = {'A', 'I', 'F', 'G', 'C', 'K', 'P', 'T'};
+constexpr size_t BLOB_ALIGNMENT = 64;
+
+enum BlobIndex {
+  WeightsBlob,
+  BiasesBlob,
+  GammaBlob,
+  BetaBlob,
+  WeightMBlob,
+  WeightVBlob,
+  BiasMBlob,
+  BiasVBlob,
+  GammaMBlob,
+  GammaVBlob,
+  BetaMBlob,
+  BetaVBlob,
+  BlobCount
+};
+
+enum LayerFlags : uint32_t {
+  NormalizeFlag = 1u << 0,
+  FrozenStatsFlag = 1u << 1,
+};
+
+struct BlobRef {
+  uint64_t offset;
+  uint64_t count; // in floats; 0 for absent optional blobs
+};
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t headerBytes;
+  uint64_t fileBytes;
+  uint32_t crc;
+  uint32_t layerCount;
+  uint32_t inputSize;
+  uint32_t optimizerType;
+  int64_t optimizerStep;
+  float momentum;
+  float rho;
+  float beta1;
+  float beta2;
+  float epsilon;
+  float weightDecay;
+  CheckpointMetadata metadata;
+};
+
+struct LayerRecord {
+  uint32_t inputSize;
+  uint32_t outputSize;
+  uint32_t activation;
+  uint32_t flags;
+  float runningMean;
+  float runningVar;
+  float epsilon;
+  uint32_t reserved;
+  BlobRef blobs[BlobCount];
+};
+
+static_assert(std::is_trivially_copyable<FileHeader>::value &&
+                  std::is_trivially_copyable<LayerRecord>::value,
+              "checkpoint records are written with memcpy");
+
+size_t alignUp(size_t offset) {
+  return (offset + BLOB_ALIGNMENT - 1) / BLOB_ALIGNMENT * BLOB_ALIGNMENT;
+}
+
+// CRC-32 (IEEE 802.3, reflected), table driven.
+uint32_t crc32Update(uint32_t crc, const unsigned char *data, size_t size) {
+  static const auto table = [] {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k)
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      t[i] = c;
+    }
+    return t;
+  }();
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i)
+    crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+  return ~crc;
+}
+
+// CRC of the whole file as if the header's crc field were zero.
+uint32_t fileCrc(const unsigned char *data, size_t size) {
+  const size_t crcOffset = offsetof(FileHeader, crc);
+  const uint32_t zero = 0;
+  uint32_t crc = crc32Update(0, data, crcOffset);
+  crc = crc32Update(crc, reinterpret_cast<const unsigned char *>(&zero),
+                    sizeof(zero));
+  const size_t rest = crcOffset + sizeof(zero);
+  return crc32Update(crc, data + rest, size - rest);
+}
+
+std::array<const std::vector<float> *, BlobCount>
+layerBlobs(const Layer &layer) {
+  const LayerNormalization &norm = layer.normalization;
+  return {&layer.weights,          &layer.biases,
+          &norm.gamma,             &norm.beta,
+          &layer.weightState.m,    &layer.weightState.v,
+          &layer.biasState.m,      &layer.biasState.v,
+          &norm.gammaState.m,      &norm.gammaState.v,
+          &norm.betaState.m,       &norm.betaState.v};
+}
+
+// Number of floats a present blob must hold.
+size_t expectedCount(const LayerRecord &record, int index) {
+  switch (index) {
+  case WeightsBlob:
+  case WeightMBlob:
+  case WeightVBlob:
+    return static_cast<size_t>(record.inputSize) * record.outputSize;
+  default:
+    return record.outputSize;
+  }
+}
+} // namespace
+
+std::vector<char> Checkpoint::serialize(const NeuralNetwork &network,
+                                        const CheckpointMetadata &metadata) {
+  const auto &layers = network.getLayers();
+  std::vector<LayerRecord> records(layers.size());
+
+  size_t offset = alignUp(sizeof(FileHeader) +
+                          records.size() * sizeof(LayerRecord));
+  for (size_t l = 0; l < layers.size(); ++l) {
+    const Layer &layer = layers[l];
+    LayerRecord &record = records[l];
+    record.inputSize = layer.inputSize;
+    record.outputSize = layer.outputSize;
+    record.activation = static_cast<uint32_t>(layer.activation);
+    record.flags = 0;
+    if (layer.use_normalization)
+      record.flags |= NormalizeFlag;
+    if (layer.normalization.use_running_stats)
+      record.flags |= FrozenStatsFlag;
+    record.runningMean = layer.normalization.running_mean;
+    record.runningVar = layer.normalization.running_var;
+    record.epsilon = layer.normalization.epsilon;
+
+    auto sources = layerBlobs(layer);
+    for (int b = 0; b < BlobCount; ++b) {
+      bool isNormBlob = b == GammaBlob || b == BetaBlob || b >= GammaMBlob;
+      size_t count = isNormBlob && !layer.use_normalization
+                         ? 0
+                         : sources[b]->size();
+      record.blobs[b] = {count > 0 ? offset : 0, count};
+      offset = alignUp(offset + count * sizeof(float));
+    }
+  }
+
+  std::vector<char> bytes(offset, 0);
+  const Optimizer &optimizer = network.getOptimizer();
+  const OptimizerConfig &config = optimizer.config();
+  FileHeader header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = FORMAT_VERSION;
+  header.headerBytes = sizeof(FileHeader);
+  header.fileBytes = bytes.size();
+  header.layerCount = static_cast<uint32_t>(layers.size());
+  header.inputSize = static_cast<uint32_t>(network.getInputSize());
+  header.optimizerType = static_cast<uint32_t>(config.type);
+  header.optimizerStep = optimizer.step();
+  header.momentum = config.momentum;
+  header.rho = config.rho;
+  header.beta1 = config.beta1;
+  header.beta2 = config.beta2;
+  header.epsilon = config.epsilon;
+  header.weightDecay = config.weightDecay;
+  header.metadata = metadata;
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  std::memcpy(bytes.data() + sizeof(header), records.data(),
+              records.size() * sizeof(LayerRecord));
+
+  for (size_t l = 0; l < layers.size(); ++l) {
+    auto sources = layerBlobs(layers[l]);
+    for (int b = 0; b < BlobCount; ++b) {
+      const BlobRef &ref = records[l].blobs[b];
+      if (ref.count > 0)
+        std::memcpy(bytes.data() + ref.offset, sources[b]->data(),
+                    ref.count * sizeof(float));
+    }
+  }
+
+  return bytes;
+}
+
+bool Checkpoint::write(const std::string &path, std::vector<char> bytes) {
+  if (bytes.size() < sizeof(FileHeader)) {
+    Logger::error("Checkpoint: refusing to write a truncated snapshot");
+    return false;
+  }
+  uint32_t crc = fileCrc(reinterpret_cast<const unsigned char *>(bytes.data()),
+                         bytes.size());
+  std::memcpy(bytes.data() + offsetof(FileHeader, crc), &crc, sizeof(crc));
+
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream ofs(temporary, std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) {
+      Logger::error("Checkpoint: cannot open %s for writing",
+                    temporary.c_str());
+      return false;
+    }
+    ofs.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!ofs.good()) {
+      Logger::error("Checkpoint: failed writing %s", temporary.c_str());
+      return false;
+    }
+  }
+  if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+    Logger::error("Checkpoint: cannot replace %s", path.c_str());
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool Checkpoint::save(const std::string &path, const NeuralNetwork &network,
+                      const CheckpointMetadata &metadata) {
+  return write(path, serialize(network, metadata));
+}
+
+Checkpoint::~Checkpoint() { close(); }
+
+void Checkpoint::close() {
+#if defined(CHECKPOINT_MMAP)
+  if (m_mapped && m_data)
+    munmap(const_cast<unsigned char *>(m_data), m_size);
+#endif
+  m_data = nullptr;
+  m_size = 0;
+  m_mapped = false;
+  m_buffer.clear();
+  m_buffer.shrink_to_fit();
+  m_layerCount = 0;
+  m_inputSize = 0;
+}
+
+bool Checkpoint::open(const std::string &path, bool verifyChecksum) {
+  close();
+
+#if defined(CHECKPOINT_MMAP)
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    Logger::error("Checkpoint: cannot open %s", path.c_str());
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    Logger::error("Checkpoint: %s is empty", path.c_str());
+    return false;
+  }
+  void *mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                       MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    Logger::error("Checkpoint: cannot map %s", path.c_str());
+    return false;
+  }
+  m_data = static_cast<const unsigned char *>(mapping);
+  m_size = static_cast<size_t>(info.st_size);
+  m_mapped = true;
+#else
+  std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+  if (!ifs.is_open()) {
+    Logger::error("Checkpoint: cannot open %s", path.c_str());
+    return false;
+  }
+  m_buffer.resize(static_cast<size_t>(ifs.tellg()));
+  ifs.seekg(0);
+  ifs.read(reinterpret_cast<char *>(m_buffer.data()),
+           static_cast<std::streamsize>(m_buffer.size()));
+  if (!ifs.good() || m_buffer.empty()) {
+    Logger::error("Checkpoint: cannot read %s", path.c_str());
+    m_buffer.clear();
+    return false;
+  }
+  m_data = m_buffer.data();
+  m_size = m_buffer.size();
+#endif
+
+  auto fail = [&](const char *reason) {
+    Logger::error("Checkpoint: %s is invalid (%s)", path.c_str(), reason);
+    close();
+    return false;
+  };
+
+  if (m_size < sizeof(FileHeader))
+    return fail("truncated header");
+  FileHeader header;
+  std::memcpy(&header, m_data, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    return fail("bad magic");
+  if (header.version != FORMAT_VERSION)
+    return fail("unsupported version");
+  if (header.headerBytes != sizeof(FileHeader) || header.fileBytes != m_size)
+    return fail("size mismatch");
+  if (header.optimizerType > static_cast<uint32_t>(OptimizerType::AdamW))
+    return fail("unknown optimizer");
+  if (header.layerCount == 0 ||
+      header.layerCount > (m_size - sizeof(FileHeader)) / sizeof(LayerRecord))
+    return fail("bad layer table");
+  if (verifyChecksum && fileCrc(m_data, m_size) != header.crc)
+    return fail("checksum mismatch");
+
+  m_layerCount = header.layerCount;
+  m_inputSize = static_cast<int>(header.inputSize);
+  m_metadata = header.metadata;
+
+  uint32_t fanIn = header.inputSize;
+  size_t widest = 0;
+  for (size_t l = 0; l < m_layerCount; ++l) {
+    LayerRecord record;
+    std::memcpy(&record, layerRecord(l), sizeof(record));
+    if (record.inputSize != fanIn || record.outputSize == 0)
+      return fail("layer shapes do not chain");
+    if (record.activation > static_cast<uint32_t>(ActivationType::GELU))
+      return fail("unknown activation");
+    for (int b = 0; b < BlobCount; ++b) {
+      const BlobRef &ref = record.blobs[b];
+      bool required = b == WeightsBlob || b == BiasesBlob ||
+                      ((b == GammaBlob || b == BetaBlob) &&
+                       (record.flags & NormalizeFlag));
+      if (ref.count == 0 && !required)
+        continue;
+      if (ref.count != expectedCount(record, b))
+        return fail("blob size mismatch");
+      if (ref.offset % alignof(float) != 0 || ref.offset > m_size ||
+          ref.count > (m_size - ref.offset) / sizeof(float))
+        return fail("blob out of bounds");
+    }
+    fanIn = record.outputSize;
+    widest = std::max<size_t>(widest, record.outputSize);
+  }
+  m_scratch[0].assign(widest, 0.0f);
+  m_scratch[1].assign(widest, 0.0f);
+  return true;
+}
+
+int Checkpoint::outputSize() const {
+  if (!isOpen())
+    return 0;
+  LayerRecord record;
+  std::memcpy(&record, layerRecord(m_layerCount - 1), sizeof(record));
+  return static_cast<int>(record.outputSize);
+}
+
+const void *Checkpoint::layerRecord(size_t index) const {
+  return m_data + sizeof(FileHeader) + index * sizeof(LayerRecord);
+}
+
+const float *Checkpoint::blob(size_t layer, int index, size_t &count) const {
+  LayerRecord record;
+  std::memcpy(&record, layerRecord(layer), sizeof(record));
+  count = record.blobs[index].count;
+  return count > 0
+             ? reinterpret_cast<const float *>(m_data +
+                                               record.blobs[index].offset)
+             : nullptr;
+}
+
+void Checkpoint::forward(const float *input, float *output) {
+  const float *in = input;
+  for (size_t l = 0; l < m_layerCount; ++l) {
+    LayerRecord record;
+    std::memcpy(&record, layerRecord(l), sizeof(record));
+    size_t count = 0;
+    const float *weights = blob(l, WeightsBlob, count);
+    const float *biases = blob(l, BiasesBlob, count);
+    float *out = l + 1 == m_layerCount ? output : m_scratch[l % 2].data();
+    const size_t fanIn = record.inputSize;
+    for (uint32_t r = 0; r < record.outputSize; ++r)
+      out[r] = biases[r] + simd::dot(weights + r * fanIn, in, fanIn);
+
+    if (record.flags & NormalizeFlag) {
+      const float *gamma = blob(l, GammaBlob, count);
+      const float *beta = blob(l, BetaBlob, count);
+      float mean = record.runningMean;
+      float var = record.runningVar;
+      if (!(record.flags & FrozenStatsFlag))
+        LayerNormalization::moments(out, record.outputSize, mean, var);
+      LayerNormalization::scaleShift(out, record.outputSize, gamma, beta,
+                                     mean,
+                                     1.0f / std::sqrt(var + record.epsilon),
+                                     nullptr);
+    }
+    activateBuffer(out, out, record.outputSize,
+                   static_cast<ActivationType>(record.activation));
+    in = out;
+  }
+}
+
+std::vector<float> Checkpoint::predict(const std::vector<float> &input) {
+  std::vector<float> output(outputSize());
+  forward(input.data(), output.data());
+  return output;
+}
+
+bool Checkpoint::restore(NeuralNetwork &network) const {
+  if (!isOpen())
+    return false;
+  if (network.getInputSize() != m_inputSize) {
+    Logger::error("Checkpoint: network expects %d inputs, checkpoint has %d",
+                  network.getInputSize(), m_inputSize);
+    return false;
+  }
+
+  FileHeader header;
+  std::memcpy(&header, m_data, sizeof(header));
+  auto copy = [&](size_t layer, int index) {
+    size_t count = 0;
+    const float *values = blob(layer, index, count);
+    return values ? std::vector<float>(values, values + count)
+                  : std::vector<float>();
+  };
+
+  network.clearLayers();
+  bool frozen = false;
+  for (size_t l = 0; l < m_layerCount; ++l) {
+    LayerRecord record;
+    std::memcpy(&record, layerRecord(l), sizeof(record));
+    bool normalize = record.flags & NormalizeFlag;
+    network.addLayer(static_cast<int>(record.outputSize),
+                     static_cast<ActivationType>(record.activation), normalize,
+                     copy(l, WeightsBlob), copy(l, BiasesBlob));
+    if (normalize)
+      network.setNormalizationParameters(l, copy(l, GammaBlob),
+                                         copy(l, BetaBlob), record.runningMean,
+                                         record.runningVar);
+    frozen = frozen || (record.flags & FrozenStatsFlag);
+  }
+  network.setNormalizationFrozen(frozen);
+
+  OptimizerConfig config;
+  config.type = static_cast<OptimizerType>(header.optimizerType);
+  config.momentum = header.momentum;
+  config.rho = header.rho;
+  config.beta1 = header.beta1;
+  config.beta2 = header.beta2;
+  config.epsilon = header.epsilon;
+  config.weightDecay = header.weightDecay;
+  network.setOptimizer(config);
+  network.setOptimizerStep(header.optimizerStep);
+  for (size_t l = 0; l < m_layerCount; ++l)
+    network.setOptimizerState(l, {copy(l, WeightMBlob), copy(l, WeightVBlob)},
+                              {copy(l, BiasMBlob), copy(l, BiasVBlob)},
+                              {copy(l, GammaMBlob), copy(l, GammaVBlob)},
+                              {copy(l, BetaMBlob), copy(l, BetaVBlob)});
+  return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "NeuralNetwork.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Training progress saved next to the weights. Fixed-size and trivially
+// copyable: it is stored verbatim in the checkpoint header.
+struct CheckpointMetadata {
+  uint64_t episodes = 0;
+  uint64_t rounds = 0;
+  uint64_t wins = 0;
+  uint64_t replaySize = 0;
+  uint64_t gradientUpdates = 0;
+  float epsilon = 0.0f;
+  float perBeta = 0.0f;
+};
+
+// Versioned binary model checkpoint:
+//
+//   header       magic, format version, optimizer config/step, metadata, CRC
+//   layer table  shape, activation, layer-norm settings and blob offsets
+//   blobs        float32 arrays (weights, biases, gamma, beta and optimizer
+//                moments), each aligned to 64 bytes
+//
+// The CRC-32 covers the whole file with the CRC field zeroed. Floats are
+// stored in native (little-endian on every supported target) order, so an
+// opened checkpoint is mapped read-only and used in place: forward() reads
+// the weights straight from the mapping, and restore() only copies when a
+// trainable network is needed. The JSON export in NeuralNetworkVisualizer is
+// kept as a human-readable debug format.
+class Checkpoint {
+public:
+  static constexpr uint32_t FORMAT_VERSION = 1;
+
+  // serialize() is a plain copy of the parameters into the file layout; the
+  // CRC and the file I/O happen in write(), which may run on another thread.
+  static std::vector<char> serialize(const NeuralNetwork &network,
+                                     const CheckpointMetadata &metadata = {});
+  // Stamps the CRC and writes to `path` through a temporary file and a
+  // rename, so readers never see a partial checkpoint.
+  static bool write(const std::string &path, std::vector<char> bytes);
+  static bool save(const std::string &path, const NeuralNetwork &network,
+                   const CheckpointMetadata &metadata = {});
+
+  Checkpoint() = default;
+  ~Checkpoint();
+  Checkpoint(const Checkpoint &) = delete;
+  Checkpoint &operator=(const Checkpoint &) = delete;
+
+  // Maps `path` and validates its header, layer table and (unless disabled)
+  // CRC. Returns false and logs the reason on failure.
+  bool open(const std::string &path, bool verifyChecksum = true);
+  void close();
+  bool isOpen() const { return m_data != nullptr; }
+
+  const CheckpointMetadata &metadata() const { return m_metadata; }
+  int inputSize() const { return m_inputSize; }
+  int outputSize() const;
+  size_t numLayers() const { return m_layerCount; }
+  size_t sizeBytes() const { return m_size; }
+
+  // Inference on the mapped parameters. `output` must hold outputSize()
+  // floats; the scratch buffers are reused between calls.
+  void forward(const float *input, float *output);
+  std::vector<float> predict(const std::vector<float> &input);
+
+  // Rebuilds `network` (shape, parameters, layer norm and optimizer state).
+  bool restore(NeuralNetwork &network) const;
+
+private:
+  const unsigned char *m_data = nullptr;
+  size_t m_size = 0;
+  bool m_mapped = false;
+  std::vector<unsigned char> m_buffer; // fallback when mmap is unavailable
+
+  CheckpointMetadata m_metadata;
+  int m_inputSize = 0;
+  size_t m_layerCount = 0;
+  std::vector<float> m_scratch[2];
+
+  const void *layerRecord(size_t index) const;
+  const float *blob(size_t layer, int index, size_t &count) const;
+};
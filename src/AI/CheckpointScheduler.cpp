@@ -0,0 +1,174 @@
+#include "CheckpointScheduler.hpp"
+#include "Checkpoint.hpp"
+#include "Core/Logger.hpp"
+#include "Core/Metrics.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+const char *ONLINE_SUFFIX = ".online.ckpt";
+const char *TARGET_SUFFIX = ".target.ckpt";
+
+bool endsWith(const std::string &value, const std::string &suffix) {
+  return value.size() >= suffix.size() &&
+         value.compare(value.size() - suffix.size(), suffix.size(), suffix) ==
+             0;
+}
+
+// Through a temporary file, so a reader never sees a partial file.
+bool writeFile(const std::string &path, const std::vector<char> &bytes) {
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+      Logger::error("Cannot write %s", temporary.c_str());
+      return false;
+    }
+  }
+  return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+} // namespace
+
+CheckpointScheduler::CheckpointScheduler(CheckpointSchedule schedule)
+    : m_schedule(std::move(schedule)),
+      m_lastTime(std::chrono::steady_clock::now()) {
+  // Adopt snapshots from earlier runs so retention covers them too. Names are
+  // zero-padded, so lexical order is update order.
+  std::error_code error;
+  const std::string prefix = m_schedule.name + "-";
+  fs::directory_iterator entries(m_schedule.directory, error);
+  for (const auto &entry : entries) {
+    std::string file = entry.path().filename().string();
+    if (file.compare(0, prefix.size(), prefix) != 0 ||
+        !endsWith(file, ONLINE_SUFFIX))
+      continue;
+    std::string base = entry.path().string();
+    base.resize(base.size() - std::char_traits<char>::length(ONLINE_SUFFIX));
+    if (fs::exists(base + TARGET_SUFFIX, error))
+      m_onDisk.push_back(base);
+  }
+  std::sort(m_onDisk.begin(), m_onDisk.end());
+}
+
+CheckpointScheduler::~CheckpointScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_wake.notify_all();
+  if (m_writer.joinable())
+    m_writer.join();
+}
+
+bool CheckpointScheduler::due(uint64_t updates) const {
+  if (m_schedule.everyUpdates > 0 &&
+      updates - m_lastUpdates >= m_schedule.everyUpdates)
+    return true;
+  if (m_schedule.everySeconds > 0.0) {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - m_lastTime;
+    return elapsed.count() >= m_schedule.everySeconds;
+  }
+  return false;
+}
+
+void CheckpointScheduler::submit(uint64_t updates, std::vector<char> online,
+                                 std::vector<char> target,
+                                 std::vector<Sidecar> sidecars) {
+  m_lastUpdates = updates;
+  m_lastTime = std::chrono::steady_clock::now();
+  auto snapshot = std::make_unique<Snapshot>(Snapshot{
+      updates, std::move(online), std::move(target), std::move(sidecars)});
+
+#ifdef __EMSCRIPTEN__
+  // No worker threads in the web build; write in place.
+  writeSnapshot(*snapshot);
+#else
+  // Started on first use, so a scheduler that never writes costs no thread.
+  if (!m_writer.joinable())
+    m_writer = std::thread(&CheckpointScheduler::run, this);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pending)
+      Logger::debug("Checkpoint writer busy, dropping snapshot at %llu",
+                    static_cast<unsigned long long>(m_pending->updates));
+    m_pending = std::move(snapshot);
+  }
+  m_wake.notify_one();
+#endif
+}
+
+void CheckpointScheduler::flush() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_idle.wait(lock, [&] { return !m_pending && !m_busy; });
+}
+
+uint64_t CheckpointScheduler::written() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_written;
+}
+
+std::string CheckpointScheduler::latest() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_onDisk.empty() ? std::string() : m_onDisk.back();
+}
+
+void CheckpointScheduler::run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_wake.wait(lock, [&] { return m_stopping || m_pending; });
+    if (!m_pending)
+      break;
+    std::unique_ptr<Snapshot> snapshot = std::move(m_pending);
+    m_busy = true;
+    lock.unlock();
+    writeSnapshot(*snapshot);
+    lock.lock();
+    m_busy = false;
+    m_idle.notify_all();
+  }
+}
+
+void CheckpointScheduler::writeSnapshot(Snapshot &snapshot) {
+  static Histogram &writeTime =
+      Metrics::histogram(MetricNames::CheckpointWriteTime);
+  ScopedTimer timer(writeTime);
+
+  std::error_code error;
+  fs::create_directories(m_schedule.directory, error);
+  char sequence[32];
+  std::snprintf(sequence, sizeof(sequence), "-%010llu",
+                static_cast<unsigned long long>(snapshot.updates));
+  const std::string base =
+      (fs::path(m_schedule.directory) / (m_schedule.name + sequence))
+          .string();
+
+  // The target file is written last: a pair only counts once both exist.
+  if (!Checkpoint::write(base + ONLINE_SUFFIX, std::move(snapshot.online)) ||
+      !Checkpoint::write(base + TARGET_SUFFIX, std::move(snapshot.target)))
+    return;
+  for (const Sidecar &sidecar : snapshot.sidecars)
+    writeFile(sidecar.path, sidecar.bytes);
+
+  std::vector<std::string> expired;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_onDisk.empty() || m_onDisk.back() != base)
+      m_onDisk.push_back(base);
+    while (m_onDisk.size() > std::max<size_t>(m_schedule.keepLast, 1)) {
+      expired.push_back(m_onDisk.front());
+      m_onDisk.pop_front();
+    }
+    ++m_written;
+  }
+  for (const std::string &old : expired) {
+    fs::remove(old + ONLINE_SUFFIX, error);
+    fs::remove(old + TARGET_SUFFIX, error);
+  }
+  Logger::debug("Checkpoint written: %s", base.c_str());
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct CheckpointSchedule {
+  std::string directory = "checkpoints";
+  std::string name = "agent"; // file prefix, one per agent
+  uint64_t everyUpdates = 5000; // 0 disables
+  double everySeconds = 600.0;  // 0 disables
+  size_t keepLast = 3;
+};
+
+// Writes periodic checkpoints from a background thread, started by the
+// first submit().
+//
+// The trainer polls due() after each gradient update and, when it returns
+// true, hands over serialized snapshots (Checkpoint::serialize, a plain copy
+// of the weights) via submit(). CRC, file I/O and retention all happen on the
+// writer thread, so a checkpoint costs the frame a memcpy. If the writer is
+// still busy, a waiting snapshot is replaced by the newer one rather than
+// queued.
+//
+// Each snapshot is a pair of files, <name>-<updates>.online.ckpt and
+// .target.ckpt, each written atomically. Only the newest `keepLast` pairs are
+// kept; older ones found in the directory at startup count too.
+//
+// A snapshot may carry sidecars, other state saved alongside the weights
+// (e.g. the opponent model). Each is already in its file format and is
+// written atomically to its own path after the pair; retention ignores it.
+class CheckpointScheduler {
+public:
+  struct Sidecar {
+    std::string path;
+    std::vector<char> bytes;
+  };
+
+  explicit CheckpointScheduler(CheckpointSchedule schedule);
+  // Finishes the pending write before returning.
+  ~CheckpointScheduler();
+
+  CheckpointScheduler(const CheckpointScheduler &) = delete;
+  CheckpointScheduler &operator=(const CheckpointScheduler &) = delete;
+
+  bool due(uint64_t updates) const;
+  void submit(uint64_t updates, std::vector<char> online,
+              std::vector<char> target, std::vector<Sidecar> sidecars = {});
+  // Blocks until every submitted snapshot has been written.
+  void flush();
+
+  const CheckpointSchedule &schedule() const { return m_schedule; }
+  uint64_t written() const;
+  // Path prefix of the newest complete snapshot on disk, or "" if none;
+  // append ".online.ckpt" / ".target.ckpt".
+  std::string latest() const;
+
+private:
+  struct Snapshot {
+    uint64_t updates;
+    std::vector<char> online;
+    std::vector<char> target;
+    std::vector<Sidecar> sidecars;
+  };
+
+  CheckpointSchedule m_schedule;
+  uint64_t m_lastUpdates = 0;
+  std::chrono::steady_clock::time_point m_lastTime;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_idle;
+  std::unique_ptr<Snapshot> m_pending;
+  bool m_busy = false;
+  bool m_stopping = false;
+  uint64_t m_written = 0;
+  std::deque<std::string> m_onDisk; // oldest first
+  std::thread m_writer;
+
+  void run();
+  void writeSnapshot(Snapshot &snapshot);
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+// The last `Frames` feature vectors of `Features` floats each, kept in a
+// circular buffer. push() overwrites the oldest frame in place, so adding a
+// frame costs one frame-sized copy and nothing shifts; copyTo() flattens the
+// stack oldest first when an observation is actually needed.
+template <size_t Frames, size_t Features> class FrameStack {
+public:
+  static constexpr size_t size = Frames * Features;
+
+  // The first frame after clear() fills every slot, so the stack never
+  // shows zeros that were not observed.
+  void push(const float *frame) {
+    if (m_count == 0) {
+      for (size_t f = 0; f < Frames; ++f)
+        std::copy(frame, frame + Features, slot(f));
+      m_count = Frames;
+      m_head = 0;
+      return;
+    }
+    std::copy(frame, frame + Features, slot(m_head));
+    m_head = (m_head + 1) % Frames;
+  }
+
+  void clear() {
+    m_count = 0;
+    m_head = 0;
+  }
+
+  bool empty() const { return m_count == 0; }
+
+  // Writes size floats, oldest frame first. m_head is the oldest slot.
+  void copyTo(float *out) const {
+    const float *oldest = m_data.data() + m_head * Features;
+    const float *end = m_data.data() + size;
+    out = std::copy(oldest, end, out);
+    std::copy(m_data.data(), oldest, out);
+  }
+
+private:
+  std::array<float, size> m_data{};
+  size_t m_head = 0;
+  size_t m_count = 0;
+
+  float *slot(size_t index) { return m_data.data() + index * Features; }
+};
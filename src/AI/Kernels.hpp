@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+// Minimal 4-wide float abstraction used by the neural network kernels.
+//
+// GCC and Clang allow the usual arithmetic operators on SSE and NEON vector
+// types, so kernels are written once as generic lambdas over `auto` lanes and
+// instantiated for both `simd::vfloat` (main loop) and `float` (tail). Targets
+// without SSE/NEON (e.g. the Emscripten build) fall back to scalar code.
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define NN_SIMD_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define NN_SIMD_NEON 1
+#endif
+
+namespace simd {
+
+inline float load(const float *p) { return *p; }
+inline void store(float *p, float v) { *p = v; }
+inline float sqrt(float v) { return std::sqrt(v); }
+inline float max(float a, float b) { return a > b ? a : b; }
+inline float min(float a, float b) { return a < b ? a : b; }
+// 1.0f where v > 0, else 0.0f.
+inline float positive(float v) { return v > 0.0f ? 1.0f : 0.0f; }
+
+#if defined(NN_SIMD_SSE)
+using vfloat = __m128;
+constexpr size_t width = 4;
+
+inline vfloat set1(float v) { return _mm_set1_ps(v); }
+inline vfloat loadv(const float *p) { return _mm_loadu_ps(p); }
+inline void store(float *p, vfloat v) { _mm_storeu_ps(p, v); }
+inline vfloat sqrt(vfloat v) { return _mm_sqrt_ps(v); }
+inline vfloat max(vfloat a, vfloat b) { return _mm_max_ps(a, b); }
+inline vfloat min(vfloat a, vfloat b) { return _mm_min_ps(a, b); }
+inline vfloat positive(vfloat v) {
+  return _mm_and_ps(_mm_cmpgt_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+inline float hsum(vfloat v) {
+  __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+  __m128 sums = _mm_add_ps(v, shuf);
+  shuf = _mm_movehl_ps(shuf, sums);
+  return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+#elif defined(NN_SIMD_NEON)
+using vfloat = float32x4_t;
+constexpr size_t width = 4;
+
+inline vfloat set1(float v) { return vdupq_n_f32(v); }
+inline vfloat loadv(const float *p) { return vld1q_f32(p); }
+inline void store(float *p, vfloat v) { vst1q_f32(p, v); }
+inline vfloat sqrt(vfloat v) { return vsqrtq_f32(v); }
+inline vfloat max(vfloat a, vfloat b) { return vmaxq_f32(a, b); }
+inline vfloat min(vfloat a, vfloat b) { return vminq_f32(a, b); }
+inline vfloat positive(vfloat v) {
+  uint32x4_t mask = vcgtq_f32(v, vdupq_n_f32(0.0f));
+  return vreinterpretq_f32_u32(
+      vandq_u32(mask, vreinterpretq_u32_f32(vdupq_n_f32(1.0f))));
+}
+inline float hsum(vfloat v) { return vaddvq_f32(v); }
+#else
+using vfloat = float;
+constexpr size_t width = 1;
+
+inline vfloat set1(float v) { return v; }
+inline vfloat loadv(const float *p) { return *p; }
+inline float hsum(float v) { return v; }
+#endif
+
+// Broadcast helpers so kernels can write `splat<V>(x)` for either lane type.
+template <typename V> inline V splat(float v);
+template <> inline float splat<float>(float v) { return v; }
+#if defined(NN_SIMD_SSE) || defined(NN_SIMD_NEON)
+template <> inline vfloat splat<vfloat>(float v) { return set1(v); }
+#endif
+
+template <typename V> inline V loadAs(const float *p);
+template <> inline float loadAs<float>(const float *p) { return *p; }
+#if defined(NN_SIMD_SSE) || defined(NN_SIMD_NEON)
+template <> inline vfloat loadAs<vfloat>(const float *p) { return loadv(p); }
+#endif
+
+// Runs `body(offset, lane)` over [0, n): full vectors first, then the scalar
+// tail. `lane` is a value-initialised vfloat/float used only for its type.
+template <typename Body> inline void forEach(size_t n, Body &&body) {
+  size_t i = 0;
+#if defined(NN_SIMD_SSE) || defined(NN_SIMD_NEON)
+  const size_t vectorEnd = n - n % width;
+  for (; i < vectorEnd; i += width)
+    body(i, vfloat{});
+#endif
+  for (; i < n; ++i)
+    body(i, 0.0f);
+}
+
+inline float dot(const float *a, const float *b, size_t n) {
+  size_t i = 0;
+  float sum = 0.0f;
+#if defined(NN_SIMD_SSE) || defined(NN_SIMD_NEON)
+  vfloat acc0 = set1(0.0f);
+  vfloat acc1 = set1(0.0f);
+  for (; i + 2 * width <= n; i += 2 * width) {
+    acc0 = acc0 + loadv(a + i) * loadv(b + i);
+    acc1 = acc1 + loadv(a + i + width) * loadv(b + i + width);
+  }
+  for (; i + width <= n; i += width)
+    acc0 = acc0 + loadv(a + i) * loadv(b + i);
+  sum = hsum(acc0 + acc1);
+#endif
+  for (; i < n; ++i)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+// y += alpha * x
+inline void axpy(float *y, const float *x, float alpha, size_t n) {
+  forEach(n, [&](size_t i, auto lane) {
+    using V = decltype(lane);
+    store(y + i, loadAs<V>(y + i) + splat<V>(alpha) * loadAs<V>(x + i));
+  });
+}
+
+inline void scale(float *y, float alpha, size_t n) {
+  forEach(n, [&](size_t i, auto lane) {
+    using V = decltype(lane);
+    store(y + i, loadAs<V>(y + i) * splat<V>(alpha));
+  });
+}
+
+// y += t * (x - y), i.e. moves y a fraction t of the way towards x.
+inline void lerp(float *y, const float *x, float t, size_t n) {
+  forEach(n, [&](size_t i, auto lane) {
+    using V = decltype(lane);
+    V current = loadAs<V>(y + i);
+    store(y + i, current + splat<V>(t) * (loadAs<V>(x + i) - current));
+  });
+}
+
+inline float sum(const float *x, size_t n) {
+  size_t i = 0;
+  float total = 0.0f;
+#if defined(NN_SIMD_SSE) || defined(NN_SIMD_NEON)
+  vfloat acc = set1(0.0f);
+  const size_t vectorEnd = n - n % width;
+  for (; i < vectorEnd; i += width)
+    acc = acc + loadv(x + i);
+  total = hsum(acc);
+#endif
+  for (; i < n; ++i)
+    total += x[i];
+  return total;
+}
+
+inline float sumOfSquares(const float *x, size_t n) { return dot(x, x, n); }
+
+} // namespace simd
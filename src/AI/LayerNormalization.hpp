@@ -1,50 +1,118 @@
+#pragma once
+#include "Kernels.hpp"
+#include "Optimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <vector>
 
+// Layer normalization over the pre-activations of one layer:
+//   y = gamma * (z - mean(z)) / sqrt(var(z) + epsilon) + beta
+//
+// Statistics are per sample, so training and inference normally run the
+// same computation. The running averages of mean/variance are tracked during
+// training and can be frozen for inference (`use_running_stats`), which
+// makes the output of a neuron independent of its siblings at play time.
 struct LayerNormalization {
-  std::vector<float> running_mean;
-  std::vector<float> running_var;
   std::vector<float> gamma;
   std::vector<float> beta;
+  std::vector<float> gammaGrads;
+  std::vector<float> betaGrads;
+  OptimizerState gammaState;
+  OptimizerState betaState;
+
+  float running_mean = 0.0f;
+  float running_var = 1.0f;
   float epsilon = 1e-5f;
   float momentum = 0.99f;
+  bool use_running_stats = false;
 
-  LayerNormalization(int size) {
-    running_mean.resize(size, 0.0f);
-    running_var.resize(size, 1.0f);
-    gamma.resize(size, 1.0f);
-    beta.resize(size, 0.0f);
-  }
+  // Cached by forward() for backward(): x_hat and 1 / sigma of the last
+  // sample.
+  std::vector<float> normalized;
+  float invStd = 1.0f;
 
-  std::vector<float> normalize(const std::vector<float> &input,
-                               bool training = true) {
-    std::vector<float> output(input.size());
+  explicit LayerNormalization(int size)
+      : gamma(size, 1.0f), beta(size, 0.0f), gammaGrads(size, 0.0f),
+        betaGrads(size, 0.0f), normalized(size, 0.0f) {}
 
+  // Training forward pass, in place on `x`. Caches x_hat and updates the
+  // running statistics.
+  void forward(float *x, size_t n) {
     float mean = 0.0f;
     float var = 0.0f;
+    moments(x, n, mean, var);
+    running_mean = momentum * running_mean + (1.0f - momentum) * mean;
+    running_var = momentum * running_var + (1.0f - momentum) * var;
+    invStd = 1.0f / std::sqrt(var + epsilon);
+    scaleShift(x, n, gamma.data(), beta.data(), mean, invStd,
+               normalized.data());
+  }
+
+  // Inference pass, in place on `x`; touches no cached state.
+  void apply(float *x, size_t n) const {
+    float mean = running_mean;
+    float var = running_var;
+    if (!use_running_stats)
+      moments(x, n, mean, var);
+    scaleShift(x, n, gamma.data(), beta.data(), mean,
+               1.0f / std::sqrt(var + epsilon), nullptr);
+  }
+
+  // Turns dL/dy into dL/dz in place and accumulates the gamma/beta
+  // gradients, using the x_hat cached by the last forward().
+  void backward(float *grad, size_t n) {
+    using simd::loadAs;
+    using simd::splat;
+    using simd::store;
+    const float *xhat = normalized.data();
+    float *dGamma = gammaGrads.data();
+    const float *g = gamma.data();
+
+    simd::axpy(betaGrads.data(), grad, 1.0f, n);
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      V dy = loadAs<V>(grad + i);
+      store(dGamma + i, loadAs<V>(dGamma + i) + dy * loadAs<V>(xhat + i));
+      store(grad + i, dy * loadAs<V>(g + i));
+    });
+
+    // dz = (dxhat - mean(dxhat) - xhat * mean(dxhat * xhat)) / sigma
+    float meanGrad = simd::sum(grad, n) / n;
+    float meanGradXhat = simd::dot(grad, xhat, n) / n;
+    const float scale = invStd;
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      V dxhat = loadAs<V>(grad + i);
+      V centered = dxhat - splat<V>(meanGrad) -
+                   loadAs<V>(xhat + i) * splat<V>(meanGradXhat);
+      store(grad + i, centered * splat<V>(scale));
+    });
+  }
+
+  void zeroGradients() {
+    std::fill(gammaGrads.begin(), gammaGrads.end(), 0.0f);
+    std::fill(betaGrads.begin(), betaGrads.end(), 0.0f);
+  }
+
+  // Mean and (biased) variance in a single pass over `x`.
+  static void moments(const float *x, size_t n, float &mean, float &var) {
+    mean = simd::sum(x, n) / n;
+    var = std::max(0.0f, simd::sumOfSquares(x, n) / n - mean * mean);
+  }
 
-    for (float val : input) {
-      mean += val;
-    }
-    mean /= input.size();
-
-    for (float val : input) {
-      float diff = val - mean;
-      var += diff * diff;
-    }
-    var /= input.size();
-
-    if (training) {
-      for (size_t i = 0; i < input.size(); ++i) {
-        running_mean[i] = momentum * running_mean[i] + (1 - momentum) * mean;
-        running_var[i] = momentum * running_var[i] + (1 - momentum) * var;
-      }
-    }
-
-    float std_dev = std::sqrt(var + epsilon);
-    for (size_t i = 0; i < input.size(); ++i) {
-      output[i] = gamma[i] * ((input[i] - mean) / std_dev) + beta[i];
-    }
-
-    return output;
+  // x = g * (x - mean) * inverseStd + b, optionally keeping x_hat.
+  static void scaleShift(float *x, size_t n, const float *g, const float *b,
+                         float mean, float inverseStd, float *xhatOut) {
+    using simd::loadAs;
+    using simd::splat;
+    using simd::store;
+    simd::forEach(n, [&](size_t i, auto lane) {
+      using V = decltype(lane);
+      V xhat = (loadAs<V>(x + i) - splat<V>(mean)) * splat<V>(inverseStd);
+      if (xhatOut)
+        store(xhatOut + i, xhat);
+      store(x + i, loadAs<V>(g + i) * xhat + loadAs<V>(b + i));
+    });
   }
 };
@@ -0,0 +1,75 @@
+#pragma once
+#include "State.hpp"
+#include <algorithm>
+#include <vector>
+
+// Turns one-step transitions into n-step ones as they are collected.
+//
+// The last n transitions are kept in a small ring. Once it is full, every
+// push emits a transition from the oldest state with the discounted sum of
+// the n rewards, the newest next state and `steps = n`, so the learner
+// bootstraps with gamma^n. A transition with `done` set (the round ended)
+// flushes the ring: each buffered start emits a shorter, done-masked
+// transition and nothing carries over into the next round.
+class NStepBuffer {
+public:
+  explicit NStepBuffer(int steps = 1, float gamma = 0.99f) {
+    configure(steps, gamma);
+  }
+
+  // Drops anything buffered.
+  void configure(int steps, float gamma) {
+    m_steps = std::max(1, steps);
+    m_gamma = gamma;
+    m_ring.assign(m_steps, Experience{});
+    clear();
+  }
+
+  void clear() {
+    m_head = 0;
+    m_count = 0;
+  }
+
+  int steps() const { return m_steps; }
+  float gamma() const { return m_gamma; }
+
+  // Calls `emit(const Experience &)` for every transition completed by `exp`.
+  template <typename Emit> void push(const Experience &exp, Emit &&emit) {
+    m_ring[(m_head + m_count) % m_steps] = exp;
+    ++m_count;
+
+    if (exp.done) {
+      while (m_count > 0)
+        emit(popOldest());
+    } else if (m_count == m_steps) {
+      emit(popOldest());
+    }
+  }
+
+private:
+  int m_steps = 1;
+  float m_gamma = 0.99f;
+  std::vector<Experience> m_ring;
+  int m_head = 0;
+  int m_count = 0;
+
+  // Folds the buffered rewards into a transition starting at the oldest
+  // entry, then drops that entry.
+  Experience popOldest() {
+    Experience result = m_ring[m_head];
+    result.reward = 0.0f;
+    float discount = 1.0f;
+    for (int k = 0; k < m_count; ++k) {
+      result.reward += discount * m_ring[(m_head + k) % m_steps].reward;
+      discount *= m_gamma;
+    }
+    const Experience &newest = m_ring[(m_head + m_count - 1) % m_steps];
+    result.nextState = newest.nextState;
+    result.steps = m_count;
+    result.done = newest.done;
+
+    m_head = (m_head + 1) % m_steps;
+    --m_count;
+    return result;
+  }
+};
@@ -1,19 +1,116 @@
 #include "NeuralNetwork.hpp"
+#include "Core/FrameArena.hpp"
+#include "Core/Metrics.hpp"
+#include "Kernels.hpp"
 
-NeuralNetwork::NeuralNetwork(int inputSize) : inputSize(inputSize) {}
+static Histogram &forwardTimeHistogram() {
+  static Histogram &histogram = Metrics::histogram(MetricNames::ForwardTime);
+  return histogram;
+}
+
+static Histogram &backwardTimeHistogram() {
+  static Histogram &histogram = Metrics::histogram(MetricNames::BackwardTime);
+  return histogram;
+}
+
+NeuralNetwork::NeuralNetwork(int inputSize)
+    : NeuralNetwork(inputSize, std::random_device{}()) {}
+
+NeuralNetwork::NeuralNetwork(int inputSize, uint32_t seed)
+    : inputSize(inputSize), m_rng(seed) {}
+
+void NeuralNetwork::addLayer(int numNeurons, ActivationType activation,
+                             bool normalize) {
+  int currentInputSize = layers.empty() ? inputSize : layers.back().outputSize;
+  Layer newLayer(currentInputSize, numNeurons, activation, normalize);
+  initializeLayer(newLayer);
+
+  layers.push_back(std::move(newLayer));
+  ++m_version;
+}
 
-void NeuralNetwork::addLayer(int numNeurons, ActivationType activation) {
+void NeuralNetwork::addLayer(int numNeurons, ActivationType activation,
+                             bool normalize, std::vector<float> weights,
+                             std::vector<float> biases) {
   int currentInputSize = layers.empty() ? inputSize : layers.back().outputSize;
-  Layer newLayer(currentInputSize, numNeurons, activation);
+  Layer newLayer(currentInputSize, numNeurons, activation, normalize);
+  if (weights.size() != newLayer.weights.size() ||
+      biases.size() != newLayer.biases.size())
+    throw std::runtime_error("Layer parameter size mismatch");
+  newLayer.weights = std::move(weights);
+  newLayer.biases = std::move(biases);
+
+  layers.push_back(std::move(newLayer));
+  ++m_version;
+}
+
+bool NeuralNetwork::sameShapeAs(const NeuralNetwork &other) const {
+  if (inputSize != other.inputSize || layers.size() != other.layers.size())
+    return false;
+  for (size_t l = 0; l < layers.size(); ++l) {
+    const Layer &mine = layers[l];
+    const Layer &theirs = other.layers[l];
+    if (mine.inputSize != theirs.inputSize ||
+        mine.outputSize != theirs.outputSize ||
+        mine.activation != theirs.activation ||
+        mine.use_normalization != theirs.use_normalization)
+      return false;
+  }
+  return true;
+}
 
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  initializeLayer(newLayer, gen);
+void NeuralNetwork::copyParametersFrom(const NeuralNetwork &other) {
+  if (!sameShapeAs(other)) {
+    inputSize = other.inputSize;
+    layers.clear();
+    for (const Layer &theirs : other.layers)
+      layers.emplace_back(theirs.inputSize, theirs.outputSize,
+                          theirs.activation, theirs.use_normalization);
+  }
 
-  layers.push_back(newLayer);
+  for (size_t l = 0; l < layers.size(); ++l) {
+    Layer &mine = layers[l];
+    const Layer &theirs = other.layers[l];
+    std::copy(theirs.weights.begin(), theirs.weights.end(),
+              mine.weights.begin());
+    std::copy(theirs.biases.begin(), theirs.biases.end(), mine.biases.begin());
+    LayerNormalization &norm = mine.normalization;
+    const LayerNormalization &source = theirs.normalization;
+    std::copy(source.gamma.begin(), source.gamma.end(), norm.gamma.begin());
+    std::copy(source.beta.begin(), source.beta.end(), norm.beta.begin());
+    norm.running_mean = source.running_mean;
+    norm.running_var = source.running_var;
+    norm.epsilon = source.epsilon;
+    norm.use_running_stats = source.use_running_stats;
+  }
+  ++m_version;
 }
 
-void NeuralNetwork::initializeLayer(Layer &layer, std::mt19937 &gen) {
+void NeuralNetwork::blendParametersFrom(const NeuralNetwork &other,
+                                        float tau) {
+  if (!sameShapeAs(other)) {
+    copyParametersFrom(other);
+    return;
+  }
+
+  for (size_t l = 0; l < layers.size(); ++l) {
+    Layer &mine = layers[l];
+    const Layer &theirs = other.layers[l];
+    simd::lerp(mine.weights.data(), theirs.weights.data(), tau,
+               mine.weights.size());
+    simd::lerp(mine.biases.data(), theirs.biases.data(), tau,
+               mine.biases.size());
+    LayerNormalization &norm = mine.normalization;
+    const LayerNormalization &source = theirs.normalization;
+    simd::lerp(norm.gamma.data(), source.gamma.data(), tau, norm.gamma.size());
+    simd::lerp(norm.beta.data(), source.beta.data(), tau, norm.beta.size());
+    norm.running_mean += tau * (source.running_mean - norm.running_mean);
+    norm.running_var += tau * (source.running_var - norm.running_var);
+  }
+  ++m_version;
+}
+
+void NeuralNetwork::initializeLayer(Layer &layer) {
   float stddev = 1.0f;
   if (layer.activation == ActivationType::ReLU) {
     stddev = std::sqrt(2.0f / layer.inputSize);
@@ -21,84 +118,224 @@ void NeuralNetwork::initializeLayer(Layer &layer, std::mt19937 &gen) {
     stddev = std::sqrt(1.0f / layer.inputSize);
   }
   std::normal_distribution<float> dist(0.0f, stddev);
-  for (int i = 0; i < layer.outputSize; ++i) {
-    for (int j = 0; j < layer.inputSize; ++j) {
-      layer.weights[i][j] = dist(gen) * 1e-3;
-    }
-    layer.biases[i] = 0.0f;
-  }
+  for (float &w : layer.weights)
+    w = dist(m_rng) * 1e-3;
+  std::fill(layer.biases.begin(), layer.biases.end(), 0.0f);
 }
 
 std::vector<float> NeuralNetwork::forward(const std::vector<float> &input) {
-  std::vector<float> activationInput = input;
+  if (layers.empty())
+    return input;
+  return forwardCached(input.data());
+}
+
+const std::vector<float> &NeuralNetwork::forwardCached(const float *input) {
+  ScopedTimer timer(forwardTimeHistogram());
+  const float *activationInput = input;
 
   for (auto &layer : layers) {
-    layer.lastInput = activationInput;
-    layer.lastZ.resize(layer.outputSize, 0.0f);
-    std::vector<float> layerOutput(layer.outputSize, 0.0f);
+    layer.lastInput.assign(activationInput, activationInput + layer.inputSize);
+    layer.lastZ.resize(layer.outputSize);
     for (int i = 0; i < layer.outputSize; ++i) {
-      float sum = layer.biases[i];
-      for (int j = 0; j < layer.inputSize; ++j) {
-        sum += layer.weights[i][j] * activationInput[j];
-      }
-      layer.lastZ[i] = sum;
-      layerOutput[i] = activate(sum, layer.activation);
+      const float *row =
+          &layer.weights[static_cast<size_t>(i) * layer.inputSize];
+      layer.lastZ[i] =
+          layer.biases[i] +
+          simd::dot(row, layer.lastInput.data(), layer.inputSize);
     }
-    layer.lastOutput = layerOutput;
-    activationInput = layerOutput;
+    if (layer.use_normalization)
+      layer.normalization.forward(layer.lastZ.data(), layer.outputSize);
+    layer.lastOutput.resize(layer.outputSize);
+    activateBuffer(layer.lastZ.data(), layer.lastOutput.data(),
+                   layer.outputSize, layer.activation);
+    activationInput = layer.lastOutput.data();
   }
-  return activationInput;
+  return layers.back().lastOutput;
+}
+
+std::vector<float>
+NeuralNetwork::predict(const std::vector<float> &input) const {
+  std::vector<float> output(getOutputSize());
+  predict(input.data(), output.data());
+  return output;
+}
+
+void NeuralNetwork::predict(const float *input, float *output) const {
+  ScopedTimer timer(forwardTimeHistogram());
+  FrameArena::Scope scope;
+  std::pmr::vector<float> current(input, input + inputSize,
+                                  &FrameArena::local());
+  std::pmr::vector<float> next(&FrameArena::local());
+  for (const auto &layer : layers) {
+    next.resize(layer.outputSize);
+    for (int i = 0; i < layer.outputSize; ++i) {
+      const float *row =
+          &layer.weights[static_cast<size_t>(i) * layer.inputSize];
+      next[i] = layer.biases[i] +
+                simd::dot(row, current.data(), layer.inputSize);
+    }
+    if (layer.use_normalization)
+      layer.normalization.apply(next.data(), layer.outputSize);
+    activateBuffer(next.data(), next.data(), layer.outputSize,
+                   layer.activation);
+    std::swap(current, next);
+  }
+  std::copy(current.begin(), current.end(), output);
+}
+
+void NeuralNetwork::predictBatch(const float *inputs, size_t count,
+                                 std::vector<float> &outputs) const {
+  ScopedTimer timer(forwardTimeHistogram());
+  FrameArena::Scope scope;
+  std::pmr::vector<float> current(inputs, inputs + count * inputSize,
+                                  &FrameArena::local());
+  std::pmr::vector<float> next(&FrameArena::local());
+  for (const auto &layer : layers) {
+    const size_t fanIn = layer.inputSize;
+    const size_t fanOut = layer.outputSize;
+    next.resize(count * fanOut);
+    for (size_t i = 0; i < fanOut; ++i) {
+      const float *row = &layer.weights[i * fanIn];
+      for (size_t b = 0; b < count; ++b)
+        next[b * fanOut + i] =
+            layer.biases[i] + simd::dot(row, &current[b * fanIn], fanIn);
+    }
+    if (layer.use_normalization)
+      for (size_t b = 0; b < count; ++b)
+        layer.normalization.apply(&next[b * fanOut], fanOut);
+    activateBuffer(next.data(), next.data(), next.size(), layer.activation);
+    std::swap(current, next);
+  }
+  outputs.assign(current.begin(), current.end());
 }
 
 void NeuralNetwork::train(const std::vector<float> &input,
                           const std::vector<float> &target,
                           float learningRate) {
+  accumulateGradients(input, target);
+  applyGradients(learningRate);
+}
 
-  std::vector<float> output = forward(input);
-  assert(output.size() == target.size());
+void NeuralNetwork::accumulateGradients(const std::vector<float> &input,
+                                        const std::vector<float> &target,
+                                        float sampleWeight) {
+  assert(input.size() == static_cast<size_t>(inputSize));
+  assert(target.size() == static_cast<size_t>(getOutputSize()));
+  accumulateGradients(input.data(), target.data(), sampleWeight);
+}
 
-  std::vector<float> delta(output.size(), 0.0f);
-  const float delta_threshold = 1.0f;
+void NeuralNetwork::accumulateGradients(const float *input,
+                                        const float *target,
+                                        float sampleWeight) {
+  const std::vector<float> &output = forwardCached(input);
+
+  m_delta.resize(output.size());
   for (size_t i = 0; i < output.size(); ++i) {
-    float error = output[i] - target[i];
-    if (std::fabs(error) <= delta_threshold)
-      delta[i] = error;
-    else
-      delta[i] = delta_threshold * ((error > 0) ? 1.0f : -1.0f);
+    float error = std::clamp(output[i] - target[i], -m_huberDelta,
+                             m_huberDelta);
+    m_delta[i] = error * sampleWeight;
   }
 
-  for (int l = layers.size() - 1; l >= 0; --l) {
+  ScopedTimer timer(backwardTimeHistogram());
+  for (int l = static_cast<int>(layers.size()) - 1; l >= 0; --l) {
     Layer &layer = layers[l];
-    std::vector<float> deltaPrev(layer.inputSize, 0.0f);
+    const size_t fanIn = layer.inputSize;
+    m_deltaPrev.assign(fanIn, 0.0f);
+    activationBackward(m_delta.data(), layer.lastZ.data(),
+                       layer.lastOutput.data(), layer.outputSize,
+                       layer.activation);
+    if (layer.use_normalization)
+      layer.normalization.backward(m_delta.data(), layer.outputSize);
 
     for (int i = 0; i < layer.outputSize; ++i) {
+      float delta_i = m_delta[i];
+      if (delta_i == 0.0f)
+        continue;
 
-      float dActivation = activateDerivative(layer.lastZ[i], layer.activation);
-      float delta_i = delta[i] * dActivation;
+      layer.biasGrads[i] += delta_i;
+      size_t rowOffset = static_cast<size_t>(i) * fanIn;
+      simd::axpy(&layer.weightGrads[rowOffset], layer.lastInput.data(),
+                 delta_i, fanIn);
+      // Weights are only updated in applyGradients, so this propagates
+      // through the same weights that produced the forward pass.
+      if (l > 0)
+        simd::axpy(m_deltaPrev.data(), &layer.weights[rowOffset], delta_i,
+                   fanIn);
+    }
+    std::swap(m_delta, m_deltaPrev);
+  }
+  ++m_accumulatedSamples;
+}
 
-      layer.biases[i] -= learningRate * delta_i;
+void NeuralNetwork::applyGradients(float learningRate) {
+  if (m_accumulatedSamples == 0)
+    return;
+
+  float batchScale = 1.0f / m_accumulatedSamples;
+  for (auto &layer : layers) {
+    simd::scale(layer.weightGrads.data(), batchScale, layer.weightGrads.size());
+    simd::scale(layer.biasGrads.data(), batchScale, layer.biasGrads.size());
+    if (layer.use_normalization) {
+      LayerNormalization &norm = layer.normalization;
+      simd::scale(norm.gammaGrads.data(), batchScale, norm.gammaGrads.size());
+      simd::scale(norm.betaGrads.data(), batchScale, norm.betaGrads.size());
+    }
+  }
+  if (m_maxGradientNorm > 0.0f)
+    clipGradients(m_maxGradientNorm);
 
-      for (int j = 0; j < layer.inputSize; ++j) {
-        float grad = delta_i * layer.lastInput[j];
-        layer.weights[i][j] -= learningRate * grad;
-        deltaPrev[j] += layer.weights[i][j] * delta_i;
-      }
+  m_optimizer.beginStep();
+  for (auto &layer : layers) {
+    m_optimizer.apply(layer.weights.data(), layer.weightGrads.data(),
+                      layer.weightState, layer.weights.size(), learningRate,
+                      true);
+    m_optimizer.apply(layer.biases.data(), layer.biasGrads.data(),
+                      layer.biasState, layer.biases.size(), learningRate,
+                      false);
+    if (layer.use_normalization) {
+      LayerNormalization &norm = layer.normalization;
+      m_optimizer.apply(norm.gamma.data(), norm.gammaGrads.data(),
+                        norm.gammaState, norm.gamma.size(), learningRate,
+                        false);
+      m_optimizer.apply(norm.beta.data(), norm.betaGrads.data(),
+                        norm.betaState, norm.beta.size(), learningRate, false);
     }
-    delta = deltaPrev;
   }
+  zeroGradients();
+  ++m_version;
+}
+
+void NeuralNetwork::zeroGradients() {
+  for (auto &layer : layers) {
+    std::fill(layer.weightGrads.begin(), layer.weightGrads.end(), 0.0f);
+    std::fill(layer.biasGrads.begin(), layer.biasGrads.end(), 0.0f);
+    layer.normalization.zeroGradients();
+  }
+  m_accumulatedSamples = 0;
+}
+
+void NeuralNetwork::setOptimizer(const OptimizerConfig &config) {
+  m_optimizer = Optimizer(config);
+  resetOptimizerState();
 }
+
+void NeuralNetwork::resetOptimizerState() {
+  m_optimizer.setStep(0);
+  for (auto &layer : layers) {
+    layer.weightState = OptimizerState();
+    layer.biasState = OptimizerState();
+    layer.normalization.gammaState = OptimizerState();
+    layer.normalization.betaState = OptimizerState();
+  }
+}
+
 void NeuralNetwork::heInitialization(Layer &layer) {
-  std::random_device rd;
-  std::mt19937 gen(rd());
   float std_dev = std::sqrt(2.0f / layer.inputSize);
   std::normal_distribution<float> dist(0.0f, std_dev);
 
-  for (int i = 0; i < layer.outputSize; ++i) {
-    for (int j = 0; j < layer.inputSize; ++j) {
-      layer.weights[i][j] = dist(gen);
-    }
-    layer.biases[i] = 0.0f;
-  }
+  for (float &w : layer.weights)
+    w = dist(m_rng);
+  std::fill(layer.biases.begin(), layer.biases.end(), 0.0f);
 }
 
 std::vector<float>
@@ -116,22 +353,32 @@ NeuralNetwork::normalizeInput(const std::vector<float> &input,
   }
   return normalized;
 }
-void NeuralNetwork::clipGradients(std::vector<std::vector<float>> &gradients,
-                                  float max_norm) {
+void NeuralNetwork::clipGradients(float max_norm) {
   float total_norm = 0.0f;
-  for (const auto &grad_vec : gradients) {
-    for (float grad : grad_vec) {
-      total_norm += grad * grad;
+  for (const auto &layer : layers) {
+    total_norm += simd::sumOfSquares(layer.weightGrads.data(),
+                                     layer.weightGrads.size());
+    total_norm +=
+        simd::sumOfSquares(layer.biasGrads.data(), layer.biasGrads.size());
+    if (layer.use_normalization) {
+      const LayerNormalization &norm = layer.normalization;
+      total_norm += simd::sumOfSquares(norm.gammaGrads.data(),
+                                       norm.gammaGrads.size());
+      total_norm +=
+          simd::sumOfSquares(norm.betaGrads.data(), norm.betaGrads.size());
     }
   }
   total_norm = std::sqrt(total_norm);
 
   if (total_norm > max_norm) {
     float scale = max_norm / total_norm;
-    for (auto &grad_vec : gradients) {
-      for (float &grad : grad_vec) {
-        grad *= scale;
-      }
+    for (auto &layer : layers) {
+      simd::scale(layer.weightGrads.data(), scale, layer.weightGrads.size());
+      simd::scale(layer.biasGrads.data(), scale, layer.biasGrads.size());
+      simd::scale(layer.normalization.gammaGrads.data(), scale,
+                  layer.normalization.gammaGrads.size());
+      simd::scale(layer.normalization.betaGrads.data(), scale,
+                  layer.normalization.betaGrads.size());
     }
   }
 }
@@ -1,95 +1,217 @@
 #pragma once
+#include "Activations.hpp"
 #include "LayerNormalization.hpp"
+#include "Optimizer.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <random>
 #include <stdexcept>
 #include <vector>
 
-enum class ActivationType { None, ReLU, Sigmoid };
-
-inline float activate(float x, ActivationType act) {
-  switch (act) {
-  case ActivationType::ReLU:
-    return x > 0 ? x : 0;
-  case ActivationType::Sigmoid:
-    return 1.0f / (1.0f + std::exp(-x));
-  case ActivationType::None:
-  default:
-    return x;
-  }
-}
-
-inline float activateDerivative(float x, ActivationType act) {
-  switch (act) {
-  case ActivationType::ReLU:
-    return x > 0 ? 1.0f : 0.0f;
-  case ActivationType::Sigmoid: {
-    float sig = 1.0f / (1.0f + std::exp(-x));
-    return sig * (1 - sig);
-  }
-  case ActivationType::None:
-  default:
-    return 1.0f;
-  }
-}
-
 struct Layer {
   int inputSize;
   int outputSize;
   ActivationType activation;
-  std::vector<std::vector<float>> weights;
+  // Row-major outputSize x inputSize, so row i is the fan-in of neuron i.
+  std::vector<float> weights;
   std::vector<float> biases;
 
+  // Gradients accumulated since the last optimizer step, and the optimizer's
+  // moment buffers, laid out like the tensors they belong to.
+  std::vector<float> weightGrads;
+  std::vector<float> biasGrads;
+  OptimizerState weightState;
+  OptimizerState biasState;
+
   std::vector<float> lastInput;
   std::vector<float> lastZ;
   std::vector<float> lastOutput;
 
+  // Applied to the pre-activations when enabled; lastZ then holds the
+  // normalized values that were fed to the activation.
   LayerNormalization normalization;
   bool use_normalization;
 
-  Layer(int inSize, int outSize, ActivationType act)
+  Layer(int inSize, int outSize, ActivationType act, bool normalize = false)
       : inputSize(inSize), outputSize(outSize), activation(act),
-        normalization(outSize), use_normalization(true) {
-    weights.resize(outSize, std::vector<float>(inSize, 0.0f));
+        normalization(outSize), use_normalization(normalize) {
+    weights.resize(static_cast<size_t>(outSize) * inSize, 0.0f);
     biases.resize(outSize, 0.0f);
+    weightGrads.resize(weights.size(), 0.0f);
+    biasGrads.resize(outSize, 0.0f);
+  }
+
+  float weight(int row, int col) const {
+    return weights[static_cast<size_t>(row) * inputSize + col];
+  }
+  float &weight(int row, int col) {
+    return weights[static_cast<size_t>(row) * inputSize + col];
   }
 };
 
 class NeuralNetwork {
 public:
   NeuralNetwork(int inputSize);
-
-  void addLayer(int numNeurons, ActivationType activation);
-
+  // Fixes the seed used to initialize layers added from now on.
+  NeuralNetwork(int inputSize, uint32_t seed);
+
+  void addLayer(int numNeurons, ActivationType activation,
+                bool normalize = false);
+  // Adds a layer with existing parameters (row-major weights) instead of
+  // random ones; used when loading models.
+  void addLayer(int numNeurons, ActivationType activation, bool normalize,
+                std::vector<float> weights, std::vector<float> biases);
+
+  // Training forward pass: caches per-layer activations for backprop and
+  // updates the layer-norm running statistics.
   std::vector<float> forward(const std::vector<float> &input);
 
+  // Inference-only forward pass. Leaves every cache untouched, and uses the
+  // frozen layer-norm statistics of layers with `use_running_stats` set.
+  std::vector<float> predict(const std::vector<float> &input) const;
+  // predict() into `output` (getOutputSize() floats). Its scratch comes
+  // from the FrameArena, so this does not touch the heap.
+  void predict(const float *input, float *output) const;
+  // predict() over `count` row-major samples at once; `outputs` receives
+  // count x output-size values. Each weight row is loaded once per batch
+  // instead of once per sample.
+  void predictBatch(const float *inputs, size_t count,
+                    std::vector<float> &outputs) const;
+
+  // Single-sample update: accumulateGradients followed by applyGradients.
   void train(const std::vector<float> &input, const std::vector<float> &target,
              float learningRate);
 
+  // Backpropagates one sample and adds its gradients to the per-layer
+  // accumulators. `sampleWeight` scales the loss (e.g. PER importance
+  // weights).
+  void accumulateGradients(const std::vector<float> &input,
+                           const std::vector<float> &target,
+                           float sampleWeight = 1.0f);
+  // Same over getInputSize() inputs and getOutputSize() targets.
+  void accumulateGradients(const float *input, const float *target,
+                           float sampleWeight = 1.0f);
+
+  // Averages the accumulated gradients over the samples seen since the last
+  // call, clips them by global norm and takes one optimizer step.
+  void applyGradients(float learningRate);
+  void zeroGradients();
+
+  void setOptimizer(const OptimizerConfig &config);
+  const Optimizer &getOptimizer() const { return m_optimizer; }
+  void resetOptimizerState();
+  // Restores optimizer progress saved with the parameters (checkpoints).
+  void setOptimizerStep(long long step) { m_optimizer.setStep(step); }
+  void setOptimizerState(size_t layerIndex, OptimizerState weightState,
+                         OptimizerState biasState, OptimizerState gammaState,
+                         OptimizerState betaState) {
+    if (layerIndex >= layers.size())
+      throw std::runtime_error("Invalid layer index");
+    Layer &layer = layers[layerIndex];
+    layer.weightState = std::move(weightState);
+    layer.biasState = std::move(biasState);
+    layer.normalization.gammaState = std::move(gammaState);
+    layer.normalization.betaState = std::move(betaState);
+  }
+
+  // Outputs errors beyond this are clipped (Huber loss gradient).
+  void setHuberDelta(float delta) { m_huberDelta = delta; }
+  float getHuberDelta() const { return m_huberDelta; }
+  // Global gradient norm limit per step; <= 0 disables clipping.
+  void setMaxGradientNorm(float norm) { m_maxGradientNorm = norm; }
+  float getMaxGradientNorm() const { return m_maxGradientNorm; }
+
   static std::vector<float> normalizeInput(const std::vector<float> &input,
                                            const std::vector<float> &input_min,
                                            const std::vector<float> &input_max);
 
   void heInitialization(Layer &layer);
 
+  int getInputSize() const { return inputSize; }
+  int getOutputSize() const {
+    return layers.empty() ? inputSize : layers.back().outputSize;
+  }
   const std::vector<Layer> &getLayers() const { return layers; }
-  void clearLayers() { layers.clear(); }
-  void setLayerParameters(size_t layerIndex,
-                          const std::vector<std::vector<float>> &weights,
+  void clearLayers() {
+    layers.clear();
+    ++m_version;
+  }
+  void setLayerParameters(size_t layerIndex, const std::vector<float> &weights,
                           const std::vector<float> &biases) {
     if (layerIndex >= layers.size())
       throw std::runtime_error("Invalid layer index");
-    layers[layerIndex].weights = weights;
-    layers[layerIndex].biases = biases;
+    Layer &layer = layers[layerIndex];
+    if (weights.size() != layer.weights.size() ||
+        biases.size() != layer.biases.size())
+      throw std::runtime_error("Layer parameter size mismatch");
+    std::copy(weights.begin(), weights.end(), layer.weights.begin());
+    std::copy(biases.begin(), biases.end(), layer.biases.begin());
+    ++m_version;
+  }
+  void setNormalizationParameters(size_t layerIndex,
+                                  const std::vector<float> &gamma,
+                                  const std::vector<float> &beta,
+                                  float runningMean, float runningVar) {
+    if (layerIndex >= layers.size())
+      throw std::runtime_error("Invalid layer index");
+    LayerNormalization &norm = layers[layerIndex].normalization;
+    if (gamma.size() != norm.gamma.size() || beta.size() != norm.beta.size())
+      throw std::runtime_error("Normalization parameter size mismatch");
+    std::copy(gamma.begin(), gamma.end(), norm.gamma.begin());
+    std::copy(beta.begin(), beta.end(), norm.beta.begin());
+    norm.running_mean = runningMean;
+    norm.running_var = runningVar;
+    ++m_version;
+  }
+  // Makes predict() use the running layer-norm statistics instead of
+  // per-sample ones. Training is unaffected.
+  void setNormalizationFrozen(bool frozen) {
+    for (auto &layer : layers)
+      layer.normalization.use_running_stats = frozen;
+    ++m_version;
+  }
+  bool normalizationFrozen() const {
+    for (const auto &layer : layers)
+      if (layer.use_normalization)
+        return layer.normalization.use_running_stats;
+    return false;
   }
   size_t numLayers() const { return layers.size(); }
 
+  // Copies the shape and parameters of `other` -- weights, biases and
+  // layer-norm state, but not gradients or optimizer state. When the shapes
+  // already match the existing buffers are reused, so refreshing an
+  // inference copy does not allocate.
+  void copyParametersFrom(const NeuralNetwork &other);
+  // Polyak averaging in place: every parameter moves a fraction `tau` of the
+  // way towards `other` in a single pass. Falls back to a copy when the
+  // shapes differ.
+  void blendParametersFrom(const NeuralNetwork &other, float tau);
+
+  // Bumped whenever the shape or parameters change, so inference copies
+  // (StaticNetwork, QuantizedNetwork) can tell when they are stale.
+  uint64_t version() const { return m_version; }
+
 private:
   int inputSize;
   std::vector<Layer> layers;
 
-  void initializeLayer(Layer &layer, std::mt19937 &gen);
-  static void clipGradients(std::vector<std::vector<float>> &gradients,
-                            float max_norm = 5.0f);
+  Optimizer m_optimizer;
+  float m_huberDelta = 1.0f;
+  float m_maxGradientNorm = 5.0f;
+  int m_accumulatedSamples = 0;
+  uint64_t m_version = 0;
+  std::vector<float> m_delta;
+  std::vector<float> m_deltaPrev;
+  std::mt19937 m_rng;
+
+  // forward() without copying the result out: returns the last layer's
+  // cached output. Requires at least one layer.
+  const std::vector<float> &forwardCached(const float *input);
+
+  void initializeLayer(Layer &layer);
+  void clipGradients(float max_norm);
+  bool sameShapeAs(const NeuralNetwork &other) const;
 };
@@ -5,8 +5,8 @@
 #include <cmath>
 #include <sstream>
 
-NeuralNetworkTreeView::NeuralNetworkTreeView(const NeuralNetwork *network)
-    : m_network(network) {}
+NeuralNetworkTreeView::NeuralNetworkTreeView(const RLAgent *agent)
+    : m_agent(agent) {}
 
 ImU32 NeuralNetworkTreeView::getWeightColor(float weight) const {
   float normalized = std::min(1.0f, std::fabs(weight));
@@ -18,9 +18,10 @@ ImU32 NeuralNetworkTreeView::getWeightColor(float weight) const {
 }
 
 void NeuralNetworkTreeView::render() {
-  if (!m_network)
+  if (!m_agent)
     return;
-  const std::vector<Layer> &layers = m_network->getLayers();
+  auto snapshot = m_agent->publishedWeights();
+  const std::vector<Layer> &layers = snapshot->network.getLayers();
   if (layers.empty())
     return;
 
@@ -65,7 +66,7 @@ void NeuralNetworkTreeView::render() {
       ImVec2 start = nodePositions[l][i];
       for (int j = 0; j < nextLayer.outputSize; ++j) {
         ImVec2 end = nodePositions[l + 1][j];
-        float weight = nextLayer.weights[j][i];
+        float weight = nextLayer.weight(j, i);
         ImU32 col = getWeightColor(weight);
         draw_list->AddLine(start, end, col, 1.0f);
       }
@@ -1,15 +1,16 @@
 #pragma once
-#include "AI/NeuralNetwork.hpp"
+#include "AI/RLAgent.hpp"
 #include "imgui.h"
 
 class NeuralNetworkTreeView {
 public:
-  NeuralNetworkTreeView(const NeuralNetwork *network);
+  // Draws the agent's published weights, never the network being trained.
+  NeuralNetworkTreeView(const RLAgent *agent);
 
   void render();
 
 private:
-  const NeuralNetwork *m_network;
+  const RLAgent *m_agent;
 
   ImU32 getWeightColor(float weight) const;
 };
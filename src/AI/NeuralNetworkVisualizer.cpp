@@ -1,58 +1,90 @@
 #include "NeuralNetworkVisualizer.hpp"
 #include "Core/Logger.hpp"
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
-#include <sstream>
 #include <utilities/json.hpp>
 
 using json = nlohmann::json;
 
-NeuralNetworkVisualizer::NeuralNetworkVisualizer(NeuralNetwork *network)
-    : network(network) {}
+namespace {
+// Appends "<value> " at offset used, truncating at the end of the buffer.
+size_t appendValue(char *text, size_t size, size_t used, float value) {
+  if (used + 1 >= size)
+    return used;
+  int written = std::snprintf(text + used, size - used, "%f ", value);
+  return written < 0 ? used : std::min(size - 1, used + written);
+}
+} // namespace
+
+NeuralNetworkVisualizer::NeuralNetworkVisualizer(RLAgent *agent)
+    : m_agent(agent) {}
 
 void NeuralNetworkVisualizer::render() {
-  if (!network)
+  if (!m_agent)
     return;
 
   ImGui::Begin("Neural Network Visualizer");
 
-  const auto &layers = network->getLayers();
-  ImGui::Text("Neural Network Structure:");
-  for (size_t i = 0; i < layers.size(); i++) {
-    const Layer &layer = layers[i];
-    std::stringstream ss;
-    ss << "Layer " << i << ": " << layer.inputSize << " -> " << layer.outputSize
-       << " ("
-       << (layer.activation == ActivationType::ReLU
-               ? "ReLU"
-               : (layer.activation == ActivationType::Sigmoid ? "Sigmoid"
-                                                              : "None"))
-       << ")";
-    if (ImGui::CollapsingHeader(ss.str().c_str())) {
-      ImGui::Text("First few weights:");
-      for (int r = 0; r < layer.outputSize && r < 5; r++) {
-        std::string row;
-        for (int c = 0; c < layer.inputSize && c < 5; c++) {
-          row += std::to_string(layer.weights[r][c]) + " ";
+  bool frozen = false;
+  {
+    // Pinned only while drawing: the buttons below may republish.
+    auto snapshot = m_agent->publishedWeights();
+    const auto &layers = snapshot->network.getLayers();
+    ImGui::Text("Optimizer: %s (step %lld), published epoch %llu",
+                optimizerTypeToString(snapshot->optimizerType),
+                snapshot->optimizerStep,
+                static_cast<unsigned long long>(snapshot.epoch()));
+    frozen = snapshot->network.normalizationFrozen();
+    bool exact = activationPrecision() == ActivationPrecision::Exact;
+    if (ImGui::Checkbox("Exact activations", &exact))
+      setActivationPrecision(exact ? ActivationPrecision::Exact
+                                   : ActivationPrecision::Fast);
+    ImGui::Text("Neural Network Structure:");
+    for (size_t i = 0; i < layers.size(); i++) {
+      const Layer &layer = layers[i];
+      char label[128];
+      std::snprintf(label, sizeof(label), "Layer %zu: %d -> %d (%s%s)", i,
+                    layer.inputSize, layer.outputSize,
+                    activationTypeToString(layer.activation),
+                    layer.use_normalization ? ", LayerNorm" : "");
+      if (ImGui::CollapsingHeader(label)) {
+        char text[512];
+        ImGui::Text("First few weights:");
+        for (int r = 0; r < layer.outputSize && r < 5; r++) {
+          size_t used = 0;
+          text[0] = '\0';
+          for (int c = 0; c < layer.inputSize && c < 5; c++)
+            used = appendValue(text, sizeof(text), used, layer.weight(r, c));
+          ImGui::Text("%s", text);
         }
-        ImGui::Text("%s", row.c_str());
+        ImGui::Text("Biases (first 10):");
+        size_t used = 0;
+        text[0] = '\0';
+        for (int i = 0; i < layer.outputSize && i < 10; i++)
+          used = appendValue(text, sizeof(text), used, layer.biases[i]);
+        ImGui::Text("%s", text);
       }
-      ImGui::Text("Biases (first 10):");
-      std::string biasesStr;
-      for (int i = 0; i < layer.outputSize && i < 10; i++) {
-        biasesStr += std::to_string(layer.biases[i]) + " ";
-      }
-      ImGui::Text("%s", biasesStr.c_str());
     }
   }
 
-  if (ImGui::Button("Export Model")) {
+  if (ImGui::Checkbox("Frozen LayerNorm statistics", &frozen)) {
+    m_agent->onlineDQN->setNormalizationFrozen(frozen);
+    m_agent->publishWeights();
+  }
+  if (ImGui::Button("Save Checkpoint"))
+    m_agent->saveCheckpoint("model.ckpt");
+  ImGui::SameLine();
+  if (ImGui::Button("Load Checkpoint"))
+    m_agent->loadCheckpoint("model.ckpt");
+  if (ImGui::Button("Export JSON")) {
     if (ExportModel("model_export.json"))
       Logger::info("Model exported successfully.");
     else
       Logger::error("Failed to export model.");
   }
   ImGui::SameLine();
-  if (ImGui::Button("Import Model")) {
+  if (ImGui::Button("Import JSON")) {
     if (ImportModel("model_export.json"))
       Logger::info("Model imported successfully.");
     else
@@ -69,7 +101,8 @@ void NeuralNetworkVisualizer::render() {
 
 bool NeuralNetworkVisualizer::ExportModel(const std::string &filename) {
   json j;
-  const auto &layers = network->getLayers();
+  auto snapshot = m_agent->publishedWeights();
+  const auto &layers = snapshot->network.getLayers();
   j["layers"] = json::array();
   for (const auto &layer : layers) {
     json jLayer;
@@ -77,7 +110,21 @@ bool NeuralNetworkVisualizer::ExportModel(const std::string &filename) {
     jLayer["outputSize"] = layer.outputSize;
     jLayer["activation"] = static_cast<int>(layer.activation);
     jLayer["biases"] = layer.biases;
-    jLayer["weights"] = layer.weights;
+    // Weights are exported one row per neuron to keep the file readable.
+    json rows = json::array();
+    for (int r = 0; r < layer.outputSize; ++r) {
+      auto begin = layer.weights.begin() + r * layer.inputSize;
+      rows.push_back(std::vector<float>(begin, begin + layer.inputSize));
+    }
+    jLayer["weights"] = rows;
+    if (layer.use_normalization) {
+      const LayerNormalization &norm = layer.normalization;
+      jLayer["normalize"] = true;
+      jLayer["gamma"] = norm.gamma;
+      jLayer["beta"] = norm.beta;
+      jLayer["runningMean"] = norm.running_mean;
+      jLayer["runningVar"] = norm.running_var;
+    }
     j["layers"].push_back(jLayer);
   }
   std::ofstream ofs(filename);
@@ -95,18 +142,31 @@ bool NeuralNetworkVisualizer::ImportModel(const std::string &filename) {
   json j;
   ifs >> j;
   ifs.close();
+  NeuralNetwork *network = m_agent->onlineDQN.get();
   network->clearLayers();
   for (const auto &jLayer : j["layers"]) {
     int inputSize = jLayer["inputSize"];
     int outputSize = jLayer["outputSize"];
     ActivationType activation =
         static_cast<ActivationType>(jLayer["activation"].get<int>());
-    network->addLayer(outputSize, activation);
+    bool normalize = jLayer.value("normalize", false);
+    std::vector<float> weights;
+    weights.reserve(static_cast<size_t>(inputSize) * outputSize);
+    for (const auto &row : jLayer["weights"]) {
+      auto values = row.get<std::vector<float>>();
+      weights.insert(weights.end(), values.begin(), values.end());
+    }
+    network->addLayer(outputSize, activation, normalize, std::move(weights),
+                      jLayer["biases"].get<std::vector<float>>());
     size_t layerIndex = network->numLayers() - 1;
-    network->setLayerParameters(
-        layerIndex, jLayer["weights"].get<std::vector<std::vector<float>>>(),
-        jLayer["biases"].get<std::vector<float>>());
+    if (normalize)
+      network->setNormalizationParameters(
+          layerIndex, jLayer["gamma"].get<std::vector<float>>(),
+          jLayer["beta"].get<std::vector<float>>(),
+          jLayer.value("runningMean", 0.0f), jLayer.value("runningVar", 1.0f));
   }
+  network->resetOptimizerState();
+  m_agent->publishWeights();
   return true;
 }
 
@@ -1,14 +1,18 @@
 #pragma once
-#include "AI/NeuralNetwork.hpp"
+#include "AI/Checkpoint.hpp"
+#include "AI/RLAgent.hpp"
 #include "imgui.h"
 #include <string>
 
 class NeuralNetworkVisualizer {
 public:
-  NeuralNetworkVisualizer(NeuralNetwork *network);
+  // Displays and exports the agent's published weights; imports and
+  // checkpoint loads edit its online network and republish.
+  NeuralNetworkVisualizer(RLAgent *agent);
 
   void render();
 
+  // Human-readable JSON dump, for debugging. Checkpoint is the fast format.
   bool ExportModel(const std::string &filename);
 
   bool ImportModel(const std::string &filename);
@@ -16,5 +20,5 @@ public:
   void CaptureSnapshot(const std::string &filename);
 
 private:
-  NeuralNetwork *network;
+  RLAgent *m_agent;
 };
@@ -0,0 +1,163 @@
+#include "OpponentModel.hpp"
+#include "Core/Logger.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace {
+constexpr uint32_t MAGIC = 0x4d50504f; // "OPPM"
+constexpr uint32_t FORMAT_VERSION = 1;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t maxOrder;
+  uint32_t actionCount;
+};
+} // namespace
+
+OpponentModel::OpponentModel(float decay) : m_decay(decay) {
+  size_t contexts = 1;
+  for (int k = 0; k <= MAX_ORDER; ++k) {
+    m_counts[k].assign(contexts * ACTION_COUNT, 0.0f);
+    m_totals[k].assign(contexts, 0.0f);
+    contexts *= ACTION_COUNT;
+  }
+  updatePrediction();
+}
+
+void OpponentModel::observe(ActionType action) {
+  const int next = static_cast<int>(action);
+  for (int k = 0; k <= m_contextLength; ++k) {
+    size_t context = contextIndex(k);
+    m_counts[k][context * ACTION_COUNT + next] += m_weight;
+    m_totals[k][context] += m_weight;
+  }
+
+  for (int i = MAX_ORDER - 1; i > 0; --i)
+    m_context[i] = m_context[i - 1];
+  m_context[0] = next;
+  m_contextLength = std::min(m_contextLength + 1, MAX_ORDER);
+
+  if (m_decay > 0.0f && m_decay < 1.0f) {
+    m_weight /= m_decay;
+    if (m_weight > MAX_WEIGHT)
+      rescale();
+  }
+  updatePrediction();
+}
+
+void OpponentModel::resetContext() {
+  m_contextLength = 0;
+  updatePrediction();
+}
+
+void OpponentModel::clear() {
+  for (int k = 0; k <= MAX_ORDER; ++k) {
+    std::fill(m_counts[k].begin(), m_counts[k].end(), 0.0f);
+    std::fill(m_totals[k].begin(), m_totals[k].end(), 0.0f);
+  }
+  m_weight = 1.0f;
+  resetContext();
+}
+
+ActionType OpponentModel::mostLikely() const {
+  return static_cast<ActionType>(
+      std::max_element(m_prediction.begin(), m_prediction.end()) -
+      m_prediction.begin());
+}
+
+float OpponentModel::attackProbability() const {
+  return probability(ActionType::Attack) +
+         probability(ActionType::JumpAttack) +
+         probability(ActionType::MoveLeftAttack) +
+         probability(ActionType::MoveRightAttack);
+}
+
+void OpponentModel::encode(float *out) const {
+  std::copy(m_prediction.begin(), m_prediction.end(), out);
+}
+
+size_t OpponentModel::contextIndex(int order) const {
+  size_t index = 0;
+  for (int i = order - 1; i >= 0; --i)
+    index = index * ACTION_COUNT + m_context[i];
+  return index;
+}
+
+void OpponentModel::rescale() {
+  const float scale = 1.0f / m_weight;
+  for (int k = 0; k <= MAX_ORDER; ++k) {
+    for (float &count : m_counts[k])
+      count *= scale;
+    for (float &total : m_totals[k])
+      total *= scale;
+  }
+  m_weight = 1.0f;
+}
+
+void OpponentModel::updatePrediction() {
+  m_prediction.fill(1.0f / ACTION_COUNT);
+  const float strength = BACKOFF_STRENGTH * m_weight;
+  for (int k = 0; k <= m_contextLength; ++k) {
+    size_t context = contextIndex(k);
+    float total = m_totals[k][context];
+    if (total <= 0.0f)
+      break;
+    const float *counts = &m_counts[k][context * ACTION_COUNT];
+    const float norm = 1.0f / (total + strength);
+    for (int a = 0; a < ACTION_COUNT; ++a)
+      m_prediction[a] = (counts[a] + strength * m_prediction[a]) * norm;
+  }
+}
+
+std::vector<char> OpponentModel::serialize() const {
+  size_t floats = 0;
+  for (int k = 0; k <= MAX_ORDER; ++k)
+    floats += m_counts[k].size() + m_totals[k].size();
+  std::vector<char> bytes(sizeof(FileHeader) + floats * sizeof(float));
+
+  FileHeader header{MAGIC, FORMAT_VERSION, MAX_ORDER, ACTION_COUNT};
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  char *out = bytes.data() + sizeof(header);
+  // Stored at weight 1 so files from different runs are comparable.
+  const float scale = 1.0f / m_weight;
+  for (int k = 0; k <= MAX_ORDER; ++k) {
+    for (const std::vector<float> *table : {&m_counts[k], &m_totals[k]}) {
+      for (float value : *table) {
+        value *= scale;
+        std::memcpy(out, &value, sizeof(value));
+        out += sizeof(value);
+      }
+    }
+  }
+  return bytes;
+}
+
+bool OpponentModel::load(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return false;
+  FileHeader header{};
+  in.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!in || header.magic != MAGIC || header.version != FORMAT_VERSION ||
+      header.maxOrder != MAX_ORDER || header.actionCount != ACTION_COUNT) {
+    Logger::warn("Ignoring incompatible opponent model %s", path.c_str());
+    return false;
+  }
+
+  OpponentModel loaded(m_decay);
+  for (int k = 0; k <= MAX_ORDER; ++k) {
+    for (std::vector<float> *table : {&loaded.m_counts[k], &loaded.m_totals[k]})
+      in.read(reinterpret_cast<char *>(table->data()),
+              table->size() * sizeof(float));
+  }
+  if (!in) {
+    Logger::warn("Truncated opponent model %s", path.c_str());
+    return false;
+  }
+  *this = std::move(loaded);
+  resetContext();
+  return true;
+}
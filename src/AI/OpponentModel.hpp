@@ -0,0 +1,69 @@
+#pragma once
+#include "State.hpp"
+#include <array>
+#include <string>
+#include <vector>
+
+// Predicts the opponent's next action from its last few actions.
+//
+// One count table per n-gram order 0..MAX_ORDER, each a flat array indexed
+// by context (the previous `order` actions in base ACTION_COUNT) and next
+// action, so an observation adds to MAX_ORDER + 1 cells. Old evidence
+// decays geometrically: rather than scaling every cell each tick, new
+// counts are added with a weight that grows by 1 / decay, and the tables
+// are renormalized only when that weight gets large.
+//
+// The prediction backs off from order 0 upwards, each order smoothing its
+// estimate towards the one below, and is recomputed once per observation.
+// Tables survive rounds (only the context is reset) and can be saved per
+// opponent.
+class OpponentModel {
+public:
+  static constexpr int MAX_ORDER = 3;
+
+  explicit OpponentModel(float decay = 0.999f);
+
+  void observe(ActionType action);
+  // Forgets the current context, e.g. at round start; keeps the tables.
+  void resetContext();
+  void clear();
+
+  void setDecay(float decay) { m_decay = decay; }
+  bool hasData() const { return m_totals[0][0] > 0.0f; }
+
+  const std::array<float, ACTION_COUNT> &prediction() const {
+    return m_prediction;
+  }
+  float probability(ActionType action) const {
+    return m_prediction[static_cast<int>(action)];
+  }
+  ActionType mostLikely() const;
+  // Combined probability of the actions that attack.
+  float attackProbability() const;
+
+  void encode(float *out) const;
+
+  // The file load() reads, as bytes; cheap enough for the game thread, the
+  // write is left to the caller (see CheckpointScheduler::Sidecar).
+  std::vector<char> serialize() const;
+  bool load(const std::string &path);
+
+private:
+  // Pseudo-counts given to the lower-order estimate when smoothing.
+  static constexpr float BACKOFF_STRENGTH = 2.0f;
+  static constexpr float MAX_WEIGHT = 1e6f;
+
+  float m_decay;
+  float m_weight = 1.0f;
+  // m_counts[k][context * ACTION_COUNT + next], m_totals[k][context].
+  std::vector<float> m_counts[MAX_ORDER + 1];
+  std::vector<float> m_totals[MAX_ORDER + 1];
+  // Newest first; only the first m_contextLength entries are valid.
+  std::array<int, MAX_ORDER> m_context{};
+  int m_contextLength = 0;
+  std::array<float, ACTION_COUNT> m_prediction{};
+
+  size_t contextIndex(int order) const;
+  void rescale();
+  void updatePrediction();
+};
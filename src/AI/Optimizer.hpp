@@ -0,0 +1,60 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+enum class OptimizerType { SGD, Momentum, RMSProp, Adam, AdamW };
+
+struct OptimizerConfig {
+  OptimizerType type = OptimizerType::Adam;
+  float momentum = 0.9f;  // SGD+momentum
+  float rho = 0.99f;      // RMSProp squared-gradient decay
+  float beta1 = 0.9f;     // Adam first moment decay
+  float beta2 = 0.999f;   // Adam second moment decay
+  float epsilon = 1e-8f;
+  float weightDecay = 0.0f; // decoupled decay, AdamW only
+};
+
+// Per-tensor moment buffers. `m` is the velocity / first moment and `v` the
+// squared-gradient average; both are laid out exactly like the parameter
+// tensor they belong to so one pass can stream all four arrays together.
+struct OptimizerState {
+  std::vector<float> m;
+  std::vector<float> v;
+
+  void reset() {
+    std::fill(m.begin(), m.end(), 0.0f);
+    std::fill(v.begin(), v.end(), 0.0f);
+  }
+};
+
+class Optimizer {
+public:
+  explicit Optimizer(const OptimizerConfig &config = OptimizerConfig());
+
+  // Advances the step counter. Call once per parameter update, before the
+  // per-tensor `apply` calls, so Adam's bias correction is shared by all
+  // tensors of the step.
+  void beginStep();
+
+  // Fused update of `n` parameters from their gradients: moments and
+  // parameters are updated in a single vectorised pass. Moment buffers are
+  // sized lazily on first use. `decay` enables weight decay for this tensor
+  // (AdamW applies it to weights but not biases).
+  void apply(float *params, const float *grads, OptimizerState &state,
+             size_t n, float learningRate, bool decay = true) const;
+
+  const OptimizerConfig &config() const { return m_config; }
+  void setConfig(const OptimizerConfig &config) { m_config = config; }
+
+  long long step() const { return m_step; }
+  void setStep(long long step) { m_step = step; }
+
+private:
+  OptimizerConfig m_config;
+  long long m_step = 0;
+  float m_biasCorrection1 = 1.0f;
+  float m_biasCorrection2 = 1.0f;
+};
+
+const char *optimizerTypeToString(OptimizerType type);
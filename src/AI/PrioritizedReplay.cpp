@@ -0,0 +1,94 @@
+#include "PrioritizedReplay.hpp"
+#include <algorithm>
+#include <cmath>
+
+PrioritizedReplay::PrioritizedReplay(size_t capacity, float alpha)
+    : m_capacity(std::max<size_t>(capacity, 1)), m_leaves(1), m_alpha(alpha) {
+  while (m_leaves < m_capacity)
+    m_leaves *= 2;
+  m_items.resize(m_capacity);
+  m_tree.assign(2 * m_leaves, 0.0f);
+}
+
+void PrioritizedReplay::add(const Experience &exp) {
+  m_items[m_next] = exp;
+  setPriority(m_next, m_maxPriority);
+  m_next = (m_next + 1) % m_capacity;
+  m_size = std::min(m_size + 1, m_capacity);
+}
+
+void PrioritizedReplay::clear() {
+  std::fill(m_tree.begin(), m_tree.end(), 0.0f);
+  m_size = 0;
+  m_next = 0;
+  m_sweep = 0;
+  m_maxPriority = 1.0f;
+}
+
+void PrioritizedReplay::sample(size_t count, float beta, std::mt19937 &rng,
+                               std::vector<size_t> &indices,
+                               std::vector<float> &weights) const {
+  indices.clear();
+  weights.clear();
+  const float total = m_tree[1];
+  if (m_size == 0 || total <= 0.0f)
+    return;
+
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  const float segment = total / count;
+  float maxWeight = 0.0f;
+  for (size_t i = 0; i < count; ++i) {
+    size_t index = find((i + unit(rng)) * segment);
+    float probability = m_tree[m_leaves + index] / total;
+    float weight = std::pow(m_size * probability, -beta);
+    indices.push_back(index);
+    weights.push_back(weight);
+    maxWeight = std::max(maxWeight, weight);
+  }
+  for (float &w : weights)
+    w /= maxWeight;
+}
+
+void PrioritizedReplay::updatePriorities(const std::vector<size_t> &indices,
+                                         const std::vector<float> &tdErrors) {
+  for (size_t i = 0; i < indices.size(); ++i) {
+    float priority =
+        std::pow(std::abs(tdErrors[i]) + PRIORITY_EPSILON, m_alpha);
+    m_maxPriority = std::max(m_maxPriority, priority);
+    setPriority(indices[i], priority);
+  }
+}
+
+void PrioritizedReplay::staleIndices(size_t count,
+                                     std::vector<size_t> &indices) {
+  indices.clear();
+  count = std::min(count, m_size);
+  for (size_t i = 0; i < count; ++i) {
+    indices.push_back(m_sweep);
+    m_sweep = (m_sweep + 1) % m_size;
+  }
+}
+
+void PrioritizedReplay::setPriority(size_t index, float priority) {
+  size_t node = m_leaves + index;
+  m_tree[node] = priority;
+  // Parents are recomputed rather than adjusted by a delta, so rounding
+  // errors do not build up over millions of updates.
+  for (node /= 2; node >= 1; node /= 2)
+    m_tree[node] = m_tree[2 * node] + m_tree[2 * node + 1];
+}
+
+size_t PrioritizedReplay::find(float prefix) const {
+  size_t node = 1;
+  while (node < m_leaves) {
+    size_t left = 2 * node;
+    if (prefix < m_tree[left] || m_tree[left + 1] <= 0.0f) {
+      node = left;
+    } else {
+      prefix -= m_tree[left];
+      node = left + 1;
+    }
+  }
+  // Rounding can land past the last filled slot; clamp to a valid entry.
+  return std::min(node - m_leaves, m_size - 1);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "State.hpp"
+#include <cstddef>
+#include <random>
+#include <vector>
+
+// Proportional prioritized experience replay.
+//
+// Transitions live in a fixed-capacity ring (the oldest is overwritten once
+// full) and their priorities (|TD error| + epsilon)^alpha in a sum tree, so
+// sampling and priority updates are O(log n). New transitions get the
+// largest priority seen so far instead of a TD estimate; the learner
+// computes real TD errors in batches -- for every sampled minibatch and for
+// a rolling sweep over entries that have not been refreshed for a while --
+// and writes them back with updatePriorities().
+class PrioritizedReplay {
+public:
+  explicit PrioritizedReplay(size_t capacity, float alpha = 0.6f);
+
+  void add(const Experience &exp);
+  void clear();
+
+  size_t size() const { return m_size; }
+  size_t capacity() const { return m_capacity; }
+  const Experience &at(size_t index) const { return m_items[index]; }
+
+  void setAlpha(float alpha) { m_alpha = alpha; }
+  float alpha() const { return m_alpha; }
+
+  // Stratified proportional sampling of `count` entries. `weights` receives
+  // the importance-sampling weights (N * P(i))^-beta, normalized so the
+  // largest in the batch is 1.
+  void sample(size_t count, float beta, std::mt19937 &rng,
+              std::vector<size_t> &indices, std::vector<float> &weights) const;
+
+  void updatePriorities(const std::vector<size_t> &indices,
+                        const std::vector<float> &tdErrors);
+
+  // The next `count` entries of a round-robin sweep over the buffer, i.e.
+  // the ones whose priorities have gone longest without a refresh.
+  void staleIndices(size_t count, std::vector<size_t> &indices);
+
+private:
+  static constexpr float PRIORITY_EPSILON = 1e-6f;
+
+  size_t m_capacity;
+  size_t m_leaves; // power of two >= capacity
+  float m_alpha;
+  std::vector<Experience> m_items;
+  // Implicit binary tree: node i has children 2i and 2i + 1, leaf k is at
+  // m_leaves + k, and m_tree[1] is the total.
+  std::vector<float> m_tree;
+  size_t m_size = 0;
+  size_t m_next = 0;
+  size_t m_sweep = 0;
+  float m_maxPriority = 1.0f;
+
+  void setPriority(size_t index, float priority);
+  size_t find(float prefix) const;
+};
@@ -0,0 +1,282 @@
+#include "QuantizedNetwork.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define QNN_X86 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define QNN_NEON 1
+#endif
+
+namespace {
+// out[r] = dot(W row r, x) for `rows` rows of `stride` bytes each.
+using GemvKernel = void (*)(const int8_t *, size_t, const int8_t *, int,
+                            int32_t *);
+
+// All kernels require `stride` to be a multiple of 32 and inputs in
+// [-127, 127].
+
+void gemvScalar(const int8_t *w, size_t stride, const int8_t *x, int rows,
+                int32_t *out) {
+  for (int r = 0; r < rows; ++r) {
+    const int8_t *row = w + r * stride;
+    int32_t sum = 0;
+    for (size_t i = 0; i < stride; ++i)
+      sum += static_cast<int32_t>(row[i]) * x[i];
+    out[r] = sum;
+  }
+}
+
+#if defined(QNN_X86) && (defined(__GNUC__) || defined(__clang__))
+#if (defined(__AVX512VNNI__) && defined(__AVX512VL__)) || defined(__AVXVNNI__)
+#define QNN_VNNI 1
+#endif
+
+// maddubs multiplies unsigned by signed bytes, so feed it |x| and w * sign(x).
+// With both operands limited to 127 the pairwise int16 sums cannot saturate.
+// VNNI's dpbusd has the same operand types but accumulates straight to int32.
+template <bool Vnni>
+__attribute__((target("avx2"), always_inline)) inline __m256i
+dotStep(__m256i acc, __m256i absX, __m256i signX, const int8_t *w) {
+  __m256i vw = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w));
+  __m256i signedW = _mm256_sign_epi8(vw, signX);
+#if defined(QNN_VNNI)
+  if (Vnni) {
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+    return _mm256_dpbusd_epi32(acc, absX, signedW);
+#else
+    return _mm256_dpbusd_avx_epi32(acc, absX, signedW);
+#endif
+  }
+#endif
+  __m256i products = _mm256_maddubs_epi16(absX, signedW);
+  return _mm256_add_epi32(acc,
+                          _mm256_madd_epi16(products, _mm256_set1_epi16(1)));
+}
+
+// Four rows share each input load and one combined horizontal reduction.
+template <bool Vnni>
+__attribute__((target("avx2"), always_inline)) inline void
+gemvAvx2Impl(const int8_t *w, size_t stride, const int8_t *x, int rows,
+             int32_t *out) {
+  int r = 0;
+  for (; r + 4 <= rows; r += 4) {
+    const int8_t *row = w + r * stride;
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    __m256i acc2 = _mm256_setzero_si256();
+    __m256i acc3 = _mm256_setzero_si256();
+    for (size_t i = 0; i < stride; i += 32) {
+      __m256i vx =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i));
+      __m256i absX = _mm256_sign_epi8(vx, vx);
+      acc0 = dotStep<Vnni>(acc0, absX, vx, row + i);
+      acc1 = dotStep<Vnni>(acc1, absX, vx, row + stride + i);
+      acc2 = dotStep<Vnni>(acc2, absX, vx, row + 2 * stride + i);
+      acc3 = dotStep<Vnni>(acc3, absX, vx, row + 3 * stride + i);
+    }
+    __m256i sums = _mm256_hadd_epi32(_mm256_hadd_epi32(acc0, acc1),
+                                     _mm256_hadd_epi32(acc2, acc3));
+    __m128i total = _mm_add_epi32(_mm256_castsi256_si128(sums),
+                                  _mm256_extracti128_si256(sums, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + r), total);
+  }
+  for (; r < rows; ++r) {
+    const int8_t *row = w + r * stride;
+    __m256i acc = _mm256_setzero_si256();
+    for (size_t i = 0; i < stride; i += 32) {
+      __m256i vx =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i));
+      acc = dotStep<Vnni>(acc, _mm256_sign_epi8(vx, vx), vx, row + i);
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                                _mm256_extracti128_si256(acc, 1));
+    sum = _mm_hadd_epi32(sum, sum);
+    sum = _mm_hadd_epi32(sum, sum);
+    out[r] = _mm_cvtsi128_si32(sum);
+  }
+}
+
+[[maybe_unused]] __attribute__((target("avx2"))) void
+gemvAvx2(const int8_t *w, size_t stride, const int8_t *x, int rows,
+         int32_t *out) {
+  gemvAvx2Impl<false>(w, stride, x, rows, out);
+}
+
+#if defined(QNN_VNNI)
+void gemvVnni(const int8_t *w, size_t stride, const int8_t *x, int rows,
+              int32_t *out) {
+  gemvAvx2Impl<true>(w, stride, x, rows, out);
+}
+#endif
+#endif
+
+#if defined(QNN_NEON)
+void gemvNeon(const int8_t *w, size_t stride, const int8_t *x, int rows,
+              int32_t *out) {
+  for (int r = 0; r < rows; ++r) {
+    const int8_t *row = w + r * stride;
+    int32x4_t acc = vdupq_n_s32(0);
+    for (size_t i = 0; i < stride; i += 16) {
+      int8x16_t vw = vld1q_s8(row + i);
+      int8x16_t vx = vld1q_s8(x + i);
+#if defined(__ARM_FEATURE_DOTPROD)
+      acc = vdotq_s32(acc, vw, vx);
+#else
+      acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(vw), vget_low_s8(vx)));
+      acc = vpadalq_s16(acc, vmull_s8(vget_high_s8(vw), vget_high_s8(vx)));
+#endif
+    }
+    out[r] = vaddvq_s32(acc);
+  }
+}
+#endif
+
+struct KernelChoice {
+  GemvKernel kernel;
+  const char *name;
+};
+
+KernelChoice selectKernel() {
+#if defined(QNN_VNNI)
+  return {gemvVnni, "VNNI"};
+#elif defined(QNN_X86) && (defined(__GNUC__) || defined(__clang__))
+  if (__builtin_cpu_supports("avx2"))
+    return {gemvAvx2, "AVX2"};
+#elif defined(QNN_NEON)
+#if defined(__ARM_FEATURE_DOTPROD)
+  return {gemvNeon, "NEON dotprod"};
+#else
+  return {gemvNeon, "NEON"};
+#endif
+#endif
+  return {gemvScalar, "scalar"};
+}
+
+const KernelChoice &kernel() {
+  static const KernelChoice choice = selectKernel();
+  return choice;
+}
+
+// Symmetric per-vector quantization; returns the dequantization scale.
+float quantizeVector(const float *values, size_t n, int8_t *out) {
+  float maxAbs = 0.0f;
+  for (size_t i = 0; i < n; ++i)
+    maxAbs = std::max(maxAbs, std::fabs(values[i]));
+  if (maxAbs == 0.0f) {
+    std::fill(out, out + n, 0);
+    return 0.0f;
+  }
+  // Round half away from zero without a libm call per element.
+  float inverse = 127.0f / maxAbs;
+  for (size_t i = 0; i < n; ++i) {
+    float scaled = values[i] * inverse;
+    out[i] = static_cast<int8_t>(scaled + (scaled >= 0.0f ? 0.5f : -0.5f));
+  }
+  return maxAbs / 127.0f;
+}
+} // namespace
+
+void QuantizedNetwork::quantize(const NeuralNetwork &network) {
+  m_layers.clear();
+  size_t widest = 0;
+  for (const Layer &layer : network.getLayers()) {
+    QuantizedLayer q;
+    q.inputSize = layer.inputSize;
+    q.outputSize = layer.outputSize;
+    q.stride = (layer.inputSize + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT *
+               ROW_ALIGNMENT;
+    q.activation = layer.activation;
+    q.weights.assign(q.stride * layer.outputSize, 0);
+    q.scales.resize(layer.outputSize);
+    q.biases = layer.biases;
+    q.normalize = layer.use_normalization;
+    if (q.normalize)
+      q.normalization = layer.normalization;
+    for (int r = 0; r < layer.outputSize; ++r) {
+      q.scales[r] = quantizeVector(
+          &layer.weights[static_cast<size_t>(r) * layer.inputSize],
+          layer.inputSize, &q.weights[r * q.stride]);
+    }
+    widest = std::max({widest, q.stride, static_cast<size_t>(q.outputSize)});
+    m_layers.push_back(std::move(q));
+  }
+  m_activations.assign(widest, 0.0f);
+  m_quantizedInput.assign(widest, 0);
+}
+
+const std::vector<float> &
+QuantizedNetwork::forward(const std::vector<float> &input) {
+  return forward(input.data());
+}
+
+const std::vector<float> &QuantizedNetwork::forward(const float *input) {
+  GemvKernel gemv = kernel().kernel;
+  const float *in = input;
+  for (const QuantizedLayer &layer : m_layers) {
+    // Padding lanes stay zero, so the kernels can run over the whole stride.
+    std::fill(m_quantizedInput.begin() + layer.inputSize,
+              m_quantizedInput.begin() + layer.stride, 0);
+    float inputScale =
+        quantizeVector(in, layer.inputSize, m_quantizedInput.data());
+
+    m_accumulators.resize(layer.outputSize);
+    gemv(layer.weights.data(), layer.stride, m_quantizedInput.data(),
+         layer.outputSize, m_accumulators.data());
+
+    m_output.resize(layer.outputSize);
+    for (int r = 0; r < layer.outputSize; ++r)
+      m_output[r] = m_accumulators[r] * layer.scales[r] * inputScale +
+                    layer.biases[r];
+    if (layer.normalize)
+      layer.normalization.apply(m_output.data(), layer.outputSize);
+    activateBuffer(m_output.data(), m_output.data(), layer.outputSize,
+                   layer.activation);
+    std::copy(m_output.begin(), m_output.end(), m_activations.begin());
+    in = m_activations.data();
+  }
+  return m_output;
+}
+
+size_t QuantizedNetwork::parameterBytes() const {
+  size_t bytes = 0;
+  for (const QuantizedLayer &layer : m_layers)
+    bytes += layer.weights.size() +
+             (layer.scales.size() + layer.biases.size()) * sizeof(float);
+  return bytes;
+}
+
+const char *QuantizedNetwork::kernelName() { return kernel().name; }
+
+QuantizationReport
+QuantizedNetwork::compare(const NeuralNetwork &reference,
+                          QuantizedNetwork &quantized,
+                          const std::vector<std::vector<float>> &states) {
+  QuantizationReport report;
+  double errorSum = 0.0;
+  size_t errorCount = 0;
+  for (const auto &state : states) {
+    std::vector<float> expected = reference.predict(state);
+    const std::vector<float> &actual = quantized.forward(state);
+
+    auto expectedBest = std::max_element(expected.begin(), expected.end()) -
+                        expected.begin();
+    auto actualBest =
+        std::max_element(actual.begin(), actual.end()) - actual.begin();
+    if (expectedBest == actualBest)
+      ++report.agreements;
+
+    for (size_t i = 0; i < expected.size(); ++i) {
+      float error = std::fabs(expected[i] - actual[i]);
+      report.maxAbsError = std::max(report.maxAbsError, error);
+      errorSum += error;
+      ++errorCount;
+    }
+    ++report.samples;
+  }
+  if (errorCount > 0)
+    report.meanAbsError = static_cast<float>(errorSum / errorCount);
+  return report;
+}
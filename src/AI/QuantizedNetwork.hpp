@@ -0,0 +1,80 @@
+#pragma once
+#include "NeuralNetwork.hpp"
+#include <cstdint>
+#include <vector>
+
+// Result of comparing a quantized network against its float32 source.
+struct QuantizationReport {
+  size_t samples = 0;
+  size_t agreements = 0; // greedy (argmax) action identical
+  float meanAbsError = 0.0f;
+  float maxAbsError = 0.0f;
+
+  float agreementRate() const {
+    return samples > 0 ? static_cast<float>(agreements) / samples : 1.0f;
+  }
+};
+
+// Inference-only int8 copy of a trained NeuralNetwork.
+//
+// Weights are quantized symmetrically per output row (scale = max|w| / 127)
+// and rows are zero-padded to a multiple of 32 so the GEMV kernels never need
+// a tail loop. Activations are quantized per layer on the fly with a single
+// per-vector scale; accumulation is exact in int32 and only the final
+// rescale, bias, layer norm and activation run in float.
+//
+// The kernel is picked once at startup: AVX-VNNI / AVX512-VNNI when compiled
+// in, AVX2 (detected at runtime on x86), NEON dot product on ARM, otherwise a
+// portable scalar loop.
+class QuantizedNetwork {
+public:
+  QuantizedNetwork() = default;
+  explicit QuantizedNetwork(const NeuralNetwork &network) {
+    quantize(network);
+  }
+
+  void quantize(const NeuralNetwork &network);
+
+  // Scratch buffers are reused, so steady-state inference does not allocate.
+  // The returned reference is valid until the next call.
+  const std::vector<float> &forward(const std::vector<float> &input);
+  const std::vector<float> &forward(const float *input);
+
+  bool empty() const { return m_layers.empty(); }
+  int inputSize() const {
+    return m_layers.empty() ? 0 : m_layers.front().inputSize;
+  }
+  int outputSize() const {
+    return m_layers.empty() ? 0 : m_layers.back().outputSize;
+  }
+  size_t parameterBytes() const;
+
+  static const char *kernelName();
+
+  // Runs both networks over `states` and counts how often they pick the same
+  // greedy action.
+  static QuantizationReport
+  compare(const NeuralNetwork &reference, QuantizedNetwork &quantized,
+          const std::vector<std::vector<float>> &states);
+
+private:
+  static constexpr size_t ROW_ALIGNMENT = 32;
+
+  struct QuantizedLayer {
+    int inputSize;
+    int outputSize;
+    size_t stride; // padded row length in bytes
+    ActivationType activation;
+    std::vector<int8_t> weights;
+    std::vector<float> scales;
+    std::vector<float> biases;
+    bool normalize;
+    LayerNormalization normalization{0};
+  };
+
+  std::vector<QuantizedLayer> m_layers;
+  std::vector<float> m_activations;
+  std::vector<float> m_output;
+  std::vector<int8_t> m_quantizedInput;
+  std::vector<int32_t> m_accumulators;
+};
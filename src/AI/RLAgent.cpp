@@ -1,7 +1,10 @@
 #include "RLAgent.hpp"
+#include "Core/FrameArena.hpp"
 #include "Core/Logger.hpp"
+#include "Core/MemoryTracker.hpp"
 #include <algorithm>
 #include <cmath>
+#include <filesystem>
 
 static constexpr float DEFAULT_EPISODE_DURATION = 60.0f;
 static constexpr int TARGET_UPDATE_FREQUENCY = 1000;
@@ -28,18 +31,34 @@ RLAgent::RLAgent(Character *character, Config &config)
       m_learningRate(0.001f), m_discountFactor(0.95f), m_episodeCount(0),
       updateCounter(0), m_wins(0), m_totalRounds(0), m_winRate(0.0f),
       m_gen(m_rd()), m_dist(0.0f, 1.0f), m_moveHoldCounter(0),
-      m_currentStance(Stance::Neutral), m_comboCount(0), m_config(config) {
-
-  state_dim = 14;
-  num_actions = 9;
+      m_currentStance(Stance::Neutral), m_comboCount(0), m_config(config),
+      m_stepCounter(Metrics::counter(MetricNames::EnvSteps)),
+      m_gradientUpdateCounter(Metrics::counter(MetricNames::GradientUpdates)),
+      m_replaySizeGauge(Metrics::gauge(MetricNames::ReplaySize)),
+      m_epsilonGauge(Metrics::gauge(MetricNames::Epsilon)),
+      m_episodeRewardGauge(Metrics::gauge(MetricNames::EpisodeReward)),
+      m_sampleLatency(Metrics::histogram(MetricNames::SampleLatency)),
+      m_tdErrors(Metrics::histogram(
+          MetricNames::TDError, Histogram::exponentialBounds(0.01, 2.0, 20))),
+      m_episodeRewards(
+          Metrics::histogram(MetricNames::EpisodeRewards,
+                             Histogram::linearBounds(-20000.0, 1000.0, 41))) {
+
+  state_dim = STATE_FEATURES;
+  num_actions = ACTION_COUNT;
 
   onlineDQN = std::make_unique<NeuralNetwork>(state_dim);
-  onlineDQN->addLayer(64, ActivationType::Sigmoid);
+  onlineDQN->addLayer(POLICY_HIDDEN_UNITS, ActivationType::Sigmoid, true);
   onlineDQN->addLayer(num_actions, ActivationType::None);
 
+  OptimizerConfig optimizer;
+  optimizer.type = OptimizerType::Adam;
+  onlineDQN->setOptimizer(optimizer);
+
   targetDQN = std::make_unique<NeuralNetwork>(state_dim);
-  targetDQN->addLayer(64, ActivationType::Sigmoid);
+  targetDQN->addLayer(POLICY_HIDDEN_UNITS, ActivationType::Sigmoid, true);
   targetDQN->addLayer(num_actions, ActivationType::None);
+  publishWeights();
 
   m_epsilon = 1.0f;
   m_epsilon_min = 0.01f;
@@ -51,37 +70,43 @@ RLAgent::RLAgent(Character *character, Config &config)
   m_battleStyle.hpRatioWeight = 1.0f;
   m_battleStyle.distancePenalty = 0.0002f;
 
-  m_lastOpponentPosition = m_character->mover.position;
-  m_opponentVelocity = Vector2f(0, 0);
-
-  reset();
+  // No opponent yet; Game::init starts the first episode against it.
+  beginEpisode(*m_character);
 }
 
-std::vector<float> RLAgent::stateToVector(const State &state) {
-  std::vector<float> v;
-
-  std::vector<float> ranges = StateNormalization::getNormalizationRanges();
-
-  v.push_back(state.distanceToOpponent / ranges[0]);
-  v.push_back(state.relativePositionX / ranges[1]);
-  v.push_back(state.relativePositionY / ranges[2]);
-  v.push_back(state.myHealth);
-  v.push_back(state.opponentHealth);
-  v.push_back(state.timeSinceLastAction / ranges[5]);
-
-  for (int i = 0; i < 4; ++i) {
-    v.push_back(state.radar[i] / ranges[6 + i]);
-  }
-
-  v.push_back(state.opponentVelocityX / ranges[10]);
-  v.push_back(state.opponentVelocityY / ranges[11]);
-
-  v.push_back(state.isCornered ? 1.0f : 0.0f);
-  v.push_back(static_cast<float>(state.currentStance) / 2.0f);
-  v.push_back(state.myStamina);
-  v.push_back(state.myMaxStamina);
+void RLAgent::encodeFrame(const State &state, float *out) const {
+  using N = StateNormalization;
+  *out++ = state.distanceToOpponent / N::MAX_DISTANCE;
+  *out++ = state.relativePositionX / N::MAX_DISTANCE;
+  *out++ = state.relativePositionY / N::MAX_DISTANCE;
+  *out++ = state.myHealth;
+  *out++ = state.opponentHealth;
+  *out++ = state.timeSinceLastAction / N::MAX_TIME;
+
+  for (int i = 0; i < 4; ++i)
+    *out++ = state.radar[i] / N::MAX_DISTANCE;
+
+  *out++ = state.opponentVelocityX / N::MAX_VELOCITY;
+  *out++ = state.opponentVelocityY / N::MAX_VELOCITY;
+
+  *out++ = state.isCornered ? 1.0f : 0.0f;
+  *out++ = static_cast<float>(state.currentStance) / 2.0f;
+  *out++ = state.myStamina;
+  *out++ = state.myMaxStamina;
+}
 
-  return v;
+void RLAgent::observe(State &state) {
+  float frame[FRAME_FEATURES];
+  encodeFrame(state, frame);
+  m_frames.push(frame);
+  float *out = state.features.data();
+  m_frames.copyTo(out);
+  out += FRAME_FEATURES * FRAME_STACK;
+  m_actionHistory.encode(out);
+  out += ACTION_HISTORY_FEATURES;
+  m_opponentActionHistory.encode(out);
+  out += ACTION_HISTORY_FEATURES;
+  m_opponentModel.encode(out);
 }
 
 State RLAgent::getCurrentState(const Character &opponent) {
@@ -115,20 +140,7 @@ State RLAgent::getCurrentState(const Character &opponent) {
       (posX < m_config.ai.deadzoneBoundary ||
        posX > m_config.windowWidth - m_config.ai.deadzoneBoundary);
 
-  std::array<ActionType, 10> selfHist = {ActionType::Noop, ActionType::Noop,
-                                         ActionType::Noop};
-  std::array<ActionType, 10> oppHist = {ActionType::Noop, ActionType::Noop,
-                                        ActionType::Noop};
-  int i = 0;
-  for (auto it = m_actionHistory.rbegin();
-       it != m_actionHistory.rend() && i < 10; ++it, ++i)
-    selfHist[i] = *it;
-  i = 0;
-  for (auto it = m_opponentActionHistory.rbegin();
-       it != m_opponentActionHistory.rend() && i < 10; ++it, ++i)
-    oppHist[i] = *it;
-  state.lastActions = selfHist;
-  state.opponentLastActions = oppHist;
+  state.opponentLastAction = m_opponentActionHistory.back();
 
   Vector2f predictedPos = opponent.mover.position + m_opponentVelocity * 0.5f;
   state.predictedDistance =
@@ -143,10 +155,34 @@ State RLAgent::getCurrentState(const Character &opponent) {
 }
 
 Action RLAgent::selectAction(const State &state) {
-  auto state_vec = stateToVector(state);
-  auto q_values = onlineDQN->forward(state_vec);
+  const float *input = state.features.data();
+  std::pmr::vector<float> q_values(&FrameArena::local());
+  if (m_useQuantizedInference) {
+    const std::vector<float> &output = m_quantizedDQN.forward(input);
+    q_values.assign(output.begin(), output.end());
+  } else {
+    auto snapshot = m_published.read();
+    if (snapshot->policyValid) {
+      q_values.resize(PolicyNetwork::outputs);
+      snapshot->policy.forward(input, q_values.data());
+    } else {
+      q_values.resize(snapshot->network.getOutputSize());
+      snapshot->network.predict(input, q_values.data());
+    }
+  }
   Action selectedAction;
 
+  if (!m_useQuantizedInference &&
+      m_decisionCount++ % RECORDED_STATE_INTERVAL == 0) {
+    if (m_recordedStates.size() < MAX_RECORDED_STATES)
+      m_recordedStates.emplace_back(state.features.begin(),
+                                    state.features.end());
+    else
+      m_recordedStates[m_nextRecordedState].assign(state.features.begin(),
+                                                   state.features.end());
+    m_nextRecordedState = (m_nextRecordedState + 1) % MAX_RECORDED_STATES;
+  }
+
   float situationalEpsilon = m_epsilon;
   if (state.myHealth < 0.3f || state.isCornered) {
     situationalEpsilon *= 1.5f;
@@ -154,7 +190,7 @@ Action RLAgent::selectAction(const State &state) {
 
   if (m_dist(m_gen) < situationalEpsilon) {
 
-    std::vector<ActionType> validActions;
+    std::pmr::vector<ActionType> validActions(&FrameArena::local());
     for (int i = 0; i < num_actions; i++) {
       validActions.push_back(static_cast<ActionType>(i));
     }
@@ -191,11 +227,9 @@ Action RLAgent::selectAction(const State &state) {
     selectedAction = Action::fromType(static_cast<ActionType>(bestAction));
   }
 
-  Action predictedOppAction = predictOpponentAction(state);
-
   if (state.myHealth < state.opponentHealth * 0.3f ||
       m_currentStance == Stance::Defensive) {
-    if (predictedOppAction.type == ActionType::Attack && m_dist(m_gen) < 0.8f) {
+    if (m_opponentModel.attackProbability() > 0.5f && m_dist(m_gen) < 0.8f) {
       selectedAction = Action::fromType(ActionType::Block);
     }
   }
@@ -217,6 +251,20 @@ Action RLAgent::selectAction(const State &state) {
   return selectedAction;
 }
 
+void RLAgent::publishWeights() {
+  if (m_hasPublished && m_publishedVersion == onlineDQN->version())
+    return;
+  PolicySnapshot &next = m_published.back();
+  next.network.copyParametersFrom(*onlineDQN);
+  next.policyValid = next.policy.loadFrom(next.network);
+  next.sourceVersion = onlineDQN->version();
+  next.optimizerType = onlineDQN->getOptimizer().config().type;
+  next.optimizerStep = onlineDQN->getOptimizer().step();
+  m_published.publish();
+  m_publishedVersion = onlineDQN->version();
+  m_hasPublished = true;
+}
+
 float RLAgent::calculateReward(const State &state, const Action &action) {
   float reward = 0.0f;
 
@@ -269,7 +317,7 @@ float RLAgent::calculateReward(const State &state, const Action &action) {
   reward += distanceScore;
 
   if (action.attack) {
-    if (m_character->lastAttackLanded) {
+    if (m_attackLanded) {
       reward += m_config.ai.hitReward;
 
       if (!m_actionHistory.empty() && m_actionHistory.back() == action.type) {
@@ -292,9 +340,9 @@ float RLAgent::calculateReward(const State &state, const Action &action) {
   }
 
   if (action.block) {
-    if (m_character->lastBlockEffective) {
+    if (m_blockEffective) {
       reward += m_config.ai.blockReward;
-      if (state.opponentLastActions[0] == ActionType::Attack) {
+      if (state.opponentLastAction == ActionType::Attack) {
         reward += m_config.ai.wellTimedBlockBonus;
       }
     } else {
@@ -309,15 +357,8 @@ float RLAgent::calculateReward(const State &state, const Action &action) {
     reward += m_config.ai.lowStaminaPenalty;
   }
 
-  if (m_actionHistory.size() >= 3) {
-    bool sameAction =
-        std::all_of(m_actionHistory.begin(), m_actionHistory.end(),
-                    [first = m_actionHistory.front()](const ActionType &act) {
-                      return act == first;
-                    });
-    if (sameAction) {
-      reward += m_config.ai.repeatActionPenalty;
-    }
+  if (m_actionHistory.size() >= 3 && m_actionHistory.allSame()) {
+    reward += m_config.ai.repeatActionPenalty;
   }
 
   reward -= m_battleStyle.timePenalty;
@@ -338,35 +379,70 @@ bool RLAgent::isPassiveNoOp(const Experience &exp) {
 }
 
 void RLAgent::updateReplayBuffer(const Experience &exp) {
-  if (isPassiveNoOp(exp))
+  if (!exp.done && isPassiveNoOp(exp))
     return;
 
-  auto s = stateToVector(exp.state);
-  auto s_next = stateToVector(exp.nextState);
-  auto current_q = onlineDQN->forward(s);
-  auto next_q = targetDQN->forward(s_next);
-  float max_next_q = *std::max_element(next_q.begin(), next_q.end());
-  int action_index = static_cast<int>(exp.action.type);
-  float td_error = std::abs(exp.reward + m_discountFactor * max_next_q -
-                            current_q[action_index]);
-
-  if (exp.action.type != ActionType::Noop) {
-    td_error *= 1.2f;
-  }
-
-  PrioritizedExperience pe{exp, td_error};
-  if (replayBuffer.size() >= MAX_REPLAY_BUFFER)
-    replayBuffer.pop();
-  replayBuffer.push(pe);
+  replayBuffer.add(exp);
+  m_replaySizeGauge.set(static_cast<double>(replayBuffer.size()));
 }
 
 void RLAgent::learn(const Experience &exp) {
-  updateReplayBuffer(exp);
+  const int steps = std::max(1, m_config.ai.nStepReturns);
+  if (m_nStep.steps() != steps || m_nStep.gamma() != m_gamma)
+    m_nStep.configure(steps, m_gamma);
+  m_nStep.push(exp, [&](const Experience &transition) {
+    updateReplayBuffer(transition);
+  });
   sampleAndTrain();
 }
 
+void RLAgent::endEpisode(const Character &opponent) {
+  if (!m_episodeActive)
+    return;
+  m_episodeActive = false;
+
+  State finalState = getCurrentState(opponent);
+  observe(finalState);
+  float reward = calculateReward(finalState, m_lastAction);
+  m_totalReward += reward;
+  m_episodeReward += reward;
+  Experience exp{m_currentState, m_lastAction, reward, finalState};
+  exp.done = true;
+  if (!m_useQuantizedInference)
+    learn(exp);
+  m_nStep.clear();
+  m_frames.clear();
+  m_opponentModel.resetContext();
+}
+
+void RLAgent::observeCombatEvents(const CombatEventQueue &events, int self) {
+  for (const CombatEvent &event : events) {
+    switch (event.type) {
+    case CombatEventType::Hit:
+      if (event.source == self)
+        m_attackLanded = true;
+      if (event.target == self)
+        m_blockEffective = false;
+      break;
+    case CombatEventType::Block:
+      if (event.source == self)
+        m_attackLanded = false;
+      if (event.target == self)
+        m_blockEffective = true;
+      break;
+    case CombatEventType::Whiff:
+      if (event.source == self)
+        m_attackLanded = false;
+      break;
+    default:
+      break;
+    }
+  }
+}
+
 void RLAgent::applyAction(const Action &action) {
-  std::string currentAnim = m_character->animator->getCurrentAnimationKey();
+  const std::string &currentAnim =
+      m_character->animator->getCurrentAnimationKey();
   bool isAttackingOrBlocking =
       (currentAnim == "Attack" || currentAnim == "Attack 2" ||
        currentAnim == "Attack 3" || currentAnim == "Block");
@@ -402,29 +478,14 @@ void RLAgent::updateStance(const State &state) {
     m_currentStance = Stance::Neutral;
 }
 
-Action RLAgent::predictOpponentAction(const State &state) {
-  if (m_opponentActionHistory.empty()) {
-    int random_action = static_cast<int>(m_dist(m_gen) * num_actions);
-    return Action::fromType(static_cast<ActionType>(random_action));
-  }
+void RLAgent::incrementEpisodeCount() {
+  m_episodeCount++;
 
-  std::map<ActionType, int> freq;
-  for (auto act : m_opponentActionHistory) {
-    freq[act]++;
-  }
-  ActionType mostCommon = m_opponentActionHistory.front();
-  int maxCount = 0;
-  for (auto &p : freq) {
-    if (p.second > maxCount) {
-      maxCount = p.second;
-      mostCommon = p.first;
-    }
-  }
-  return Action::fromType(mostCommon);
+  m_episodeRewards.observe(m_episodeReward);
+  m_episodeRewardGauge.set(m_episodeReward);
+  m_episodeReward = 0.0f;
 }
 
-void RLAgent::incrementEpisodeCount() { m_episodeCount++; }
-
 void RLAgent::reportWin(bool didWin) {
   m_totalRounds++;
   if (didWin) {
@@ -439,30 +500,137 @@ void RLAgent::reportWin(bool didWin) {
 }
 
 void RLAgent::updateTargetNetwork() {
+  targetDQN->copyParametersFrom(*onlineDQN);
+  Logger::debug("Target network updated");
+}
+
+CheckpointMetadata RLAgent::checkpointMetadata() const {
+  CheckpointMetadata metadata;
+  metadata.episodes = m_episodeCount;
+  metadata.rounds = m_totalRounds;
+  metadata.wins = m_wins;
+  metadata.replaySize = replayBuffer.size();
+  metadata.gradientUpdates = m_gradientUpdates;
+  metadata.epsilon = m_epsilon;
+  metadata.perBeta = m_per_beta;
+  return metadata;
+}
+
+bool RLAgent::saveCheckpoint(const std::string &path) const {
+  if (!Checkpoint::save(path, *onlineDQN, checkpointMetadata()))
+    return false;
+  Logger::info("Checkpoint saved to %s (episode %d)", path.c_str(),
+               m_episodeCount);
+  return true;
+}
 
-  const auto &onlineLayers = onlineDQN->getLayers();
-  for (size_t i = 0; i < onlineLayers.size(); ++i) {
-    targetDQN->setLayerParameters(i, onlineLayers[i].weights,
-                                  onlineLayers[i].biases);
+bool RLAgent::loadCheckpoint(const std::string &path,
+                             const std::string &targetPath) {
+  Checkpoint checkpoint;
+  if (!checkpoint.open(path))
+    return false;
+  if (checkpoint.inputSize() != state_dim) {
+    Logger::error("Checkpoint %s expects %d inputs, the agent encodes %d",
+                  path.c_str(), checkpoint.inputSize(), state_dim);
+    return false;
   }
-  Logger::debug("Target network updated");
+  if (!checkpoint.restore(*onlineDQN))
+    return false;
+  Checkpoint target;
+  if (targetPath.empty() || !target.open(targetPath) ||
+      !target.restore(*targetDQN))
+    updateTargetNetwork();
+
+  const CheckpointMetadata &metadata = checkpoint.metadata();
+  m_episodeCount = static_cast<int>(metadata.episodes);
+  m_totalRounds = static_cast<int>(metadata.rounds);
+  m_wins = static_cast<int>(metadata.wins);
+  m_winRate =
+      m_totalRounds > 0 ? static_cast<float>(m_wins) / m_totalRounds : 0.0f;
+  m_epsilon = metadata.epsilon;
+  m_per_beta = metadata.perBeta;
+  m_gradientUpdates = metadata.gradientUpdates;
+  m_epsilonGauge.set(m_epsilon);
+  publishWeights();
+  if (m_useQuantizedInference)
+    setQuantizedInference(true);
+  Logger::info("Checkpoint loaded from %s (episode %d, %zu bytes)",
+               path.c_str(), m_episodeCount, checkpoint.sizeBytes());
+  return true;
+}
+
+void RLAgent::initCheckpoints(const std::string &name) {
+  CheckpointSchedule schedule;
+  schedule.name = name;
+  schedule.everyUpdates =
+      static_cast<uint64_t>(std::max(0, m_config.ai.checkpointEveryUpdates));
+  schedule.everySeconds = m_config.ai.checkpointEveryMinutes * 60.0;
+  schedule.keepLast =
+      static_cast<size_t>(std::max(1, m_config.ai.checkpointsToKeep));
+  m_checkpoints = std::make_unique<CheckpointScheduler>(schedule);
+
+  m_opponentModelPath =
+      (std::filesystem::path(schedule.directory) / (name + ".opponent"))
+          .string();
+  if (m_opponentModel.load(m_opponentModelPath))
+    Logger::info("Opponent model loaded from %s", m_opponentModelPath.c_str());
+}
+
+bool RLAgent::resumeLatestCheckpoint() {
+  std::string base = m_checkpoints ? m_checkpoints->latest() : "";
+  if (base.empty()) {
+    Logger::warn("No checkpoint to resume from");
+    return false;
+  }
+  return loadCheckpoint(base + ".online.ckpt", base + ".target.ckpt");
+}
+
+void RLAgent::maybeCheckpoint() {
+  if (!m_checkpoints || !m_config.ai.autoCheckpoint ||
+      !m_checkpoints->due(m_gradientUpdates))
+    return;
+  static Histogram &snapshotTime =
+      Metrics::histogram(MetricNames::CheckpointSnapshotTime);
+  ScopedTimer timer(snapshotTime);
+  CheckpointMetadata metadata = checkpointMetadata();
+  m_checkpoints->submit(m_gradientUpdates,
+                        Checkpoint::serialize(*onlineDQN, metadata),
+                        Checkpoint::serialize(*targetDQN, metadata),
+                        {{m_opponentModelPath, m_opponentModel.serialize()}});
+}
+
+void RLAgent::setQuantizedInference(bool enabled) {
+  m_useQuantizedInference = enabled;
+  if (!enabled)
+    return;
+
+  m_quantizedDQN.quantize(*onlineDQN);
+  m_quantizationReport =
+      QuantizedNetwork::compare(*onlineDQN, m_quantizedDQN, m_recordedStates);
+  Logger::info("Quantized inference (%s): %zu bytes, %.1f%% greedy agreement "
+               "over %zu states, max |dQ| %.4f",
+               QuantizedNetwork::kernelName(), m_quantizedDQN.parameterBytes(),
+               m_quantizationReport.agreementRate() * 100.0f,
+               m_quantizationReport.samples, m_quantizationReport.maxAbsError);
+  if (m_quantizationReport.agreementRate() < MIN_QUANTIZED_AGREEMENT)
+    Logger::warn("Quantized network disagrees with float32 on %.1f%% of "
+                 "recorded states",
+                 (1.0f - m_quantizationReport.agreementRate()) * 100.0f);
 }
 
 void RLAgent::trackActionHistory(ActionType action, bool isOpponent) {
   if (isOpponent) {
-    m_opponentActionHistory.push_back(action);
-    if (m_opponentActionHistory.size() > 10)
-      m_opponentActionHistory.pop_front();
+    m_opponentActionHistory.push(action);
+    m_opponentModel.setDecay(m_config.ai.opponentModelDecay);
+    m_opponentModel.observe(action);
   } else {
-    m_actionHistory.push_back(action);
-    if (m_actionHistory.size() > 10)
-      m_actionHistory.pop_front();
+    m_actionHistory.push(action);
   }
 }
 
 void RLAgent::updateComboSystem(const Action &action) {
   if (action.attack) {
-    if (m_character->lastAttackLanded) {
+    if (m_attackLanded) {
       m_comboCount++;
       m_totalReward += 5.0f * m_comboCount;
     } else {
@@ -474,6 +642,10 @@ void RLAgent::updateComboSystem(const Action &action) {
 }
 
 void RLAgent::update(float deltaTime, const Character &opponent) {
+  MemoryTracker::Scope memoryScope(MemorySubsystem::AI);
+  m_stepCounter.increment();
+  publishWeights();
+
   if (m_episodeCount > 0)
     decayEpsilon();
 
@@ -487,7 +659,7 @@ void RLAgent::update(float deltaTime, const Character &opponent) {
   m_lastOpponentPosition = opponent.mover.position;
 
   {
-    std::string oppAnim = opponent.animator->getCurrentAnimationKey();
+    const std::string &oppAnim = opponent.animator->getCurrentAnimationKey();
     ActionType oppAction = animationKeyToActionType(oppAnim);
     trackActionHistory(oppAction, true);
   }
@@ -497,6 +669,7 @@ void RLAgent::update(float deltaTime, const Character &opponent) {
   m_currentActionDuration += deltaTime;
 
   State newState = getCurrentState(opponent);
+  observe(newState);
   updateStance(newState);
   if (m_currentActionDuration >= m_actionHoldDuration) {
     Action newAction = selectAction(newState);
@@ -507,8 +680,6 @@ void RLAgent::update(float deltaTime, const Character &opponent) {
     } else {
       m_actionHoldDuration = 0.3f;
     }
-    trackActionHistory(m_lastAction.type, false);
-
     float healthDiff = m_character->health - m_lastHealth;
     if (healthDiff != 0) {
       if (healthDiff < 0)
@@ -520,10 +691,14 @@ void RLAgent::update(float deltaTime, const Character &opponent) {
     m_lastHealth = m_character->health;
     float reward = calculateReward(newState, newAction);
     m_totalReward += reward;
+    m_episodeReward += reward;
     Experience exp{m_currentState, m_lastAction, reward, newState};
-    learn(exp);
+    if (!m_useQuantizedInference && m_episodeActive)
+      learn(exp);
+    m_episodeActive = true;
     m_currentState = newState;
     m_lastAction = newAction;
+    trackActionHistory(newAction.type, false);
     m_currentActionDuration = 0;
     updateComboSystem(newAction);
     Logger::debug("Selected action: %s", actionTypeToString(m_lastAction.type));
@@ -531,64 +706,53 @@ void RLAgent::update(float deltaTime, const Character &opponent) {
   applyAction(m_lastAction);
 }
 
-void RLAgent::reset() {
+void RLAgent::reset(const Character &opponent) {
   m_totalReward = 0;
+  beginEpisode(opponent);
+}
+
+void RLAgent::beginEpisode(const Character &opponent) {
   m_episodeTime = 0;
-  m_currentState = getCurrentState(*m_character);
-  m_lastAction = Action::fromType(ActionType::Noop);
-  while (!replayBuffer.empty())
-    replayBuffer.pop();
+  m_timeSinceLastAction = 0;
+  m_currentActionDuration = 0;
+  m_consecutiveWhiffs = 0;
+  m_lastHealth = m_character->health;
   m_moveHoldCounter = 0;
   m_comboCount = 0;
+  m_attackLanded = false;
+  m_blockEffective = false;
+  m_currentStance = Stance::Neutral;
+  m_lastOpponentPosition = opponent.mover.position;
+  m_opponentVelocity = Vector2f(0, 0);
   m_actionHistory.clear();
   m_opponentActionHistory.clear();
-}
-
-void RLAgent::startNewEpoch() {
-  bool didWin = (m_character->health > (m_character->maxHealth * 0.5f));
-  reportWin(didWin);
+  m_opponentModel.resetContext();
+  m_nStep.clear();
+  m_frames.clear();
+  m_episodeActive = false;
+  m_lastAction = Action::fromType(ActionType::Noop);
 
-  m_character->mover.position = {100, 100};
-  m_character->health = m_character->maxHealth;
-  reset();
-  Logger::info("Starting new epoch, reward reset.");
+  m_currentState = getCurrentState(opponent);
+  observe(m_currentState);
 }
 
-float RLAgent::calculatePriority(float td_error) const {
-
-  return std::pow(std::abs(td_error) + PRIORITY_EPSILON, m_per_alpha);
+void RLAgent::clearReplayBuffer() {
+  replayBuffer.clear();
+  m_replaySizeGauge.set(0.0);
 }
 
-float RLAgent::calculateImportanceWeight(float priority,
-                                         float max_priority) const {
-
-  float normalized_priority = priority / max_priority;
-  return std::pow(normalized_priority, -m_per_beta);
+float RLAgent::bootstrapDiscount(const Experience &exp) const {
+  return exp.done ? 0.0f : std::pow(m_gamma, static_cast<float>(exp.steps));
 }
 
 void RLAgent::softUpdateTargetNetwork() {
-  const auto &online_layers = onlineDQN->getLayers();
-  const auto &target_layers = targetDQN->getLayers();
-
-  for (size_t i = 0; i < online_layers.size(); ++i) {
-    std::vector<std::vector<float>> new_weights = target_layers[i].weights;
-    std::vector<float> new_biases = target_layers[i].biases;
-
-    for (size_t j = 0; j < new_weights.size(); ++j) {
-      for (size_t k = 0; k < new_weights[j].size(); ++k) {
-        new_weights[j][k] = m_tau * online_layers[i].weights[j][k] +
-                            (1 - m_tau) * target_layers[i].weights[j][k];
-      }
-      new_biases[j] = m_tau * online_layers[i].biases[j] +
-                      (1 - m_tau) * target_layers[i].biases[j];
-    }
-
-    targetDQN->setLayerParameters(i, new_weights, new_biases);
-  }
+  targetDQN->blendParametersFrom(*onlineDQN, m_tau);
 }
 
-std::vector<float> RLAgent::getActionMask(const State &state) const {
-  std::vector<float> mask(num_actions, 1.0f);
+std::array<float, ACTION_COUNT>
+RLAgent::getActionMask(const State &state) const {
+  std::array<float, ACTION_COUNT> mask;
+  mask.fill(1.0f);
 
   if (state.isCornered) {
     float posX = m_character->mover.position.x;
@@ -613,68 +777,101 @@ std::vector<float> RLAgent::getActionMask(const State &state) const {
   return mask;
 }
 
-void RLAgent::sampleAndTrain() {
-  if (replayBuffer.size() < MIN_EXPERIENCES_BEFORE_TRAINING) {
-    return;
+void RLAgent::evaluateTDErrors(TDBatch &batch) {
+  const size_t count = batch.indices.size();
+  batch.states.resize(count * state_dim);
+  batch.nextStates.resize(count * state_dim);
+  for (size_t i = 0; i < count; ++i) {
+    const Experience &exp = replayBuffer.at(batch.indices[i]);
+    std::copy_n(exp.state.features.begin(), state_dim,
+                batch.states.begin() + i * state_dim);
+    std::copy_n(exp.nextState.features.begin(), state_dim,
+                batch.nextStates.begin() + i * state_dim);
   }
 
-  std::vector<Experience> batch;
-  std::vector<float> priorities;
-  std::vector<float> weights;
-  float max_priority = replayBuffer.top().priority;
-
-  for (int i = 0; i < BATCH_SIZE && !replayBuffer.empty(); ++i) {
-    auto exp = replayBuffer.top();
-    batch.push_back(exp.exp);
-    priorities.push_back(exp.priority);
-    weights.push_back(calculateImportanceWeight(exp.priority, max_priority));
-    replayBuffer.pop();
-  }
+  onlineDQN->predictBatch(batch.states.data(), count, batch.currentQ);
+  targetDQN->predictBatch(batch.nextStates.data(), count, batch.nextQ);
+  onlineDQN->predictBatch(batch.nextStates.data(), count, batch.onlineNextQ);
+
+  batch.targets.resize(count);
+  batch.tdErrors.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    const Experience &exp = replayBuffer.at(batch.indices[i]);
+    auto current_mask = getActionMask(exp.state);
+    auto next_mask = getActionMask(exp.nextState);
+    float *current_q = &batch.currentQ[i * num_actions];
+    const float *next_q = &batch.nextQ[i * num_actions];
+    const float *online_next_q = &batch.onlineNextQ[i * num_actions];
+
+    int best_action = 0;
+    for (int j = 0; j < num_actions; ++j) {
+      current_q[j] *= current_mask[j];
+      if (online_next_q[j] * next_mask[j] >
+          online_next_q[best_action] * next_mask[best_action])
+        best_action = j;
+    }
+    float next_q_value = next_q[best_action] * next_mask[best_action];
 
-  float max_weight = *std::max_element(weights.begin(), weights.end());
-  for (auto &w : weights) {
-    w /= max_weight;
+    float scaled_reward = exp.reward * m_reward_scale;
+    float target = scaled_reward + bootstrapDiscount(exp) * next_q_value;
+    int action_index = static_cast<int>(exp.action.type);
+    batch.targets[i] = target;
+    batch.tdErrors[i] = target - current_q[action_index];
   }
+}
 
-  for (size_t i = 0; i < batch.size(); ++i) {
-    auto &experience = batch[i];
-
-    auto current_state = stateToVector(experience.state);
-    auto next_state = stateToVector(experience.nextState);
-
-    auto current_mask = getActionMask(experience.state);
-    auto next_mask = getActionMask(experience.nextState);
-
-    auto current_q = onlineDQN->forward(current_state);
-    auto next_q = targetDQN->forward(next_state);
-    auto online_next_q = onlineDQN->forward(next_state);
+void RLAgent::refreshStalePriorities() {
+  if (m_config.ai.priorityRefreshBatch <= 0)
+    return;
+  replayBuffer.staleIndices(m_config.ai.priorityRefreshBatch,
+                            m_sweepBatch.indices);
+  evaluateTDErrors(m_sweepBatch);
+  replayBuffer.updatePriorities(m_sweepBatch.indices, m_sweepBatch.tdErrors);
+}
 
-    for (size_t j = 0; j < current_q.size(); ++j) {
-      current_q[j] *= current_mask[j];
-      next_q[j] *= next_mask[j];
-      online_next_q[j] *= next_mask[j];
-    }
+void RLAgent::sampleAndTrain() {
+  if (replayBuffer.size() < MIN_EXPERIENCES_BEFORE_TRAINING) {
+    return;
+  }
 
-    int best_action =
-        std::max_element(online_next_q.begin(), online_next_q.end()) -
-        online_next_q.begin();
-    float next_q_value = next_q[best_action];
+  TDBatch &batch = m_trainBatch;
+  {
+    ScopedTimer timer(m_sampleLatency);
+    replayBuffer.sample(BATCH_SIZE, m_per_beta, m_gen, batch.indices,
+                        batch.weights);
+  }
+  evaluateTDErrors(batch);
 
-    float scaled_reward = experience.reward * m_reward_scale;
-    float target = scaled_reward + m_gamma * next_q_value;
+  std::pmr::vector<float> current_q(num_actions, &FrameArena::local());
+  for (size_t i = 0; i < batch.indices.size(); ++i) {
+    const Experience &experience = replayBuffer.at(batch.indices[i]);
+    std::copy_n(&batch.currentQ[i * num_actions], num_actions,
+                current_q.begin());
 
     int action_index = static_cast<int>(experience.action.type);
-    current_q[action_index] = target;
+    m_tdErrors.observe(std::abs(batch.tdErrors[i]));
+    current_q[action_index] = batch.targets[i];
 
-    float effective_lr = m_learningRate * weights[i];
-    onlineDQN->train(current_state, current_q, effective_lr);
+    onlineDQN->accumulateGradients(&batch.states[i * state_dim],
+                                   current_q.data(), batch.weights[i]);
   }
-
-  softUpdateTargetNetwork();
+  onlineDQN->applyGradients(m_learningRate);
+  m_gradientUpdateCounter.increment();
+  ++m_gradientUpdates;
+
+  replayBuffer.updatePriorities(batch.indices, batch.tdErrors);
+  refreshStalePriorities();
+
+  const int interval = std::max(1, m_config.ai.targetUpdateInterval);
+  if (m_gradientUpdates % interval == 0)
+    softUpdateTargetNetwork();
+  publishWeights();
+  maybeCheckpoint();
 }
 
 void RLAgent::decayEpsilon() {
   m_epsilon = std::max(m_epsilon_min, m_epsilon * m_epsilon_decay);
+  m_epsilonGauge.set(m_epsilon);
 
   m_per_beta = std::min(1.0f, m_per_beta + 0.001f);
 }
@@ -1,33 +1,69 @@
 #pragma once
+#include "AI/Checkpoint.hpp"
+#include "AI/ActionHistory.hpp"
+#include "AI/CheckpointScheduler.hpp"
+#include "AI/FrameStack.hpp"
+#include "AI/NStepBuffer.hpp"
 #include "AI/NeuralNetwork.hpp"
+#include "AI/OpponentModel.hpp"
+#include "AI/PrioritizedReplay.hpp"
+#include "AI/QuantizedNetwork.hpp"
+#include "AI/StaticNetwork.hpp"
 #include "Core/Config.hpp"
+#include "Core/DoubleBuffered.hpp"
+#include "Core/Metrics.hpp"
 #include "Game/Character.hpp"
+#include "Game/CombatEvents.hpp"
 #include "State.hpp"
-#include <deque>
 #include <memory>
-#include <queue>
 #include <random>
 #include <vector>
 
-struct PrioritizedExperience {
-  Experience exp;
-  float priority;
-  bool operator<(const PrioritizedExperience &other) const {
-    return priority < other.priority;
-  }
+// Deployed shape of the Q-network. The trainable NeuralNetworks are built
+// with the same layers, and greedy action selection runs on this fixed-shape
+// copy whenever the online network matches it.
+constexpr int POLICY_HIDDEN_UNITS = 64;
+using PolicyNetwork =
+    StaticNetwork<STATE_FEATURES,
+                  Dense<POLICY_HIDDEN_UNITS, ActivationType::Sigmoid, true>,
+                  Dense<ACTION_COUNT, ActivationType::None>>;
+
+// Inference copy of the online network. The learner publishes a new one
+// whenever onlineDQN changes; action selection and the visualizers only read
+// pinned snapshots, so they never observe a half-applied update.
+struct PolicySnapshot {
+  NeuralNetwork network{STATE_FEATURES};
+  PolicyNetwork policy;
+  bool policyValid = false; // network matches PolicyNetwork's shape
+  uint64_t sourceVersion = 0;
+  OptimizerType optimizerType = OptimizerType::Adam;
+  long long optimizerStep = 0;
 };
 
 class RLAgent {
 public:
   RLAgent(Character *character, Config &config);
   void update(float deltaTime, const Character &opponent);
-  void reset();
-  void startNewEpoch();
+  // Starts a fresh episode against `opponent` and zeroes the reward tally.
+  // Per-episode state only; the replay memory is kept, see
+  // clearReplayBuffer().
+  void reset(const Character &opponent);
+  void clearReplayBuffer();
+  // Round boundary: drops everything that describes the round just played
+  // (histories, combo, held moves, contact outcome, frame stack) and
+  // observes the restored fighters. O(1); nothing learned is touched.
+  void beginEpisode(const Character &opponent);
 
   Action lastAction() const { return m_lastAction; }
   float totalReward() { return m_totalReward; }
   void reportWin(bool didWin);
   void incrementEpisodeCount();
+  // Called when the round ends: records the final, terminal transition so
+  // the n-step returns in flight are cut at the round boundary.
+  void endEpisode(const Character &opponent);
+  // Reward stage: reads the tick's combat events as fighter `self`, so the
+  // next reward knows whether its last attack landed or its guard held.
+  void observeCombatEvents(const CombatEventQueue &events, int self);
 
   void setEpsilonParameters(float start, float min, float decay) {
     m_epsilon_start = start;
@@ -44,6 +80,7 @@ public:
   void setPERParameters(float alpha, float beta) {
     m_per_alpha = alpha;
     m_per_beta = beta;
+    replayBuffer.setAlpha(alpha);
   }
 
   float getEpsilon() const { return m_epsilon; }
@@ -56,8 +93,46 @@ public:
   }
 
   void updateTargetNetwork();
+
+  // Learner side: publishes onlineDQN if it changed since the last publish.
+  // Code that edits onlineDQN outside of training (model import, hot-load)
+  // calls this to make the change visible.
+  void publishWeights();
+  DoubleBuffered<PolicySnapshot>::ReadGuard publishedWeights() const {
+    return m_published.read();
+  }
   const State &getCurrentState() const { return m_currentState; }
 
+  // Switches action selection to an int8 copy of the online network and
+  // freezes learning (the copy is not retrained). Enabling re-quantizes the
+  // current weights and checks greedy-action agreement on recently seen
+  // states.
+  void setQuantizedInference(bool enabled);
+  bool usesQuantizedInference() const { return m_useQuantizedInference; }
+  const QuantizationReport &getQuantizationReport() const {
+    return m_quantizationReport;
+  }
+
+  // Binary checkpoint of the online network (with optimizer state) and the
+  // training progress. Loading also resets the target network to it; the
+  // replay buffer itself is not saved.
+  bool saveCheckpoint(const std::string &path) const;
+  // `targetPath`, if given, restores the target network too instead of
+  // copying the online one.
+  bool loadCheckpoint(const std::string &path,
+                      const std::string &targetPath = "");
+  CheckpointMetadata checkpointMetadata() const;
+
+  // Names this agent's checkpoints (one name per agent), adopts the ones
+  // already on disk for resumeLatestCheckpoint() and reloads the opponent
+  // model saved with them as <name>.opponent. Nothing is written unless
+  // Config::ai.autoCheckpoint is on.
+  void initCheckpoints(const std::string &name);
+  bool resumeLatestCheckpoint();
+  const CheckpointScheduler *checkpointScheduler() const {
+    return m_checkpoints.get();
+  }
+
   int getEpisodeCount() const { return m_episodeCount; }
 
   int getTotalRounds() const { return m_totalRounds; }
@@ -67,19 +142,23 @@ public:
   void setBattleStyle(const BattleStyle &style) { m_battleStyle = style; }
 
   Stance getCurrentStance() const { return m_currentStance; }
-  const std::deque<ActionType> &getActionHistory() const {
-    return m_actionHistory;
-  }
-  const std::deque<ActionType> &getOpponentActionHistory() const {
+  const ActionHistory &getActionHistory() const { return m_actionHistory; }
+  const ActionHistory &getOpponentActionHistory() const {
     return m_opponentActionHistory;
   }
+  const OpponentModel &getOpponentModel() const { return m_opponentModel; }
   std::vector<float> m_qValueHistory;
   std::unique_ptr<NeuralNetwork> onlineDQN;
   std::unique_ptr<NeuralNetwork> targetDQN;
 
 private:
-  std::vector<float> stateToVector(const State &state);
   State getCurrentState(const Character &opponent);
+  // Normalizes one observation into FRAME_FEATURES floats.
+  void encodeFrame(const State &state, float *out) const;
+  // Pushes the state's frame onto the frame stack and stores the stacked
+  // input, both action history blocks and the opponent prediction in
+  // state.features.
+  void observe(State &state);
   Action selectAction(const State &state);
   float calculateReward(const State &state, const Action &action);
   void learn(const Experience &exp);
@@ -89,7 +168,6 @@ private:
   bool isPassiveNoOp(const Experience &exp);
 
   void updateStance(const State &state);
-  Action predictOpponentAction(const State &state);
   void trackActionHistory(ActionType action, bool isOpponent);
   void decayEpsilon();
   void updateComboSystem(const Action &action);
@@ -119,8 +197,8 @@ private:
   int m_totalRounds;
   float m_winRate;
 
-  std::priority_queue<PrioritizedExperience> replayBuffer;
   static const size_t MAX_REPLAY_BUFFER = 40000;
+  PrioritizedReplay replayBuffer{MAX_REPLAY_BUFFER};
   static const size_t BATCH_SIZE = 32;
 
   std::random_device m_rd;
@@ -133,9 +211,18 @@ private:
   BattleStyle m_battleStyle;
 
   Stance m_currentStance;
-  std::deque<ActionType> m_actionHistory;
-  std::deque<ActionType> m_opponentActionHistory;
+  ActionHistory m_actionHistory;
+  ActionHistory m_opponentActionHistory;
+  OpponentModel m_opponentModel;
+  // Where the opponent model is kept between runs, next to the agent's
+  // checkpoints; empty until initCheckpoints().
+  std::string m_opponentModelPath;
   int m_comboCount;
+  // Outcome of the latest contact involving this fighter, from the combat
+  // events: a Hit lands, a Block or Whiff does not; the guard holds until
+  // the fighter is hit.
+  bool m_attackLanded = false;
+  bool m_blockEffective = false;
 
   Config &m_config;
 
@@ -144,6 +231,29 @@ private:
 
   std::vector<Experience> m_batchBuffer;
 
+  FrameStack<FRAME_STACK, FRAME_FEATURES> m_frames;
+  NStepBuffer m_nStep;
+  // False until the first decision of a round, so no transition spans two
+  // rounds.
+  bool m_episodeActive = false;
+
+  DoubleBuffered<PolicySnapshot> m_published;
+  uint64_t m_publishedVersion = 0;
+  bool m_hasPublished = false;
+
+  QuantizedNetwork m_quantizedDQN;
+  QuantizationReport m_quantizationReport;
+  bool m_useQuantizedInference = false;
+  // Ring of network inputs, used to validate the quantized network: one
+  // float32 decision in RECORDED_STATE_INTERVAL is kept, so the ring spans
+  // a longer stretch of play and most decisions copy nothing.
+  std::vector<std::vector<float>> m_recordedStates;
+  size_t m_nextRecordedState = 0;
+  size_t m_decisionCount = 0;
+  static constexpr size_t MAX_RECORDED_STATES = 1024;
+  static constexpr size_t RECORDED_STATE_INTERVAL = 8;
+  static constexpr float MIN_QUANTIZED_AGREEMENT = 0.95f;
+
   float m_epsilon_min = 0.01f;
   float m_epsilon_decay = 0.995f;
   float m_epsilon_start = 1.0f;
@@ -153,12 +263,44 @@ private:
   float m_reward_scale = 1.0f;
 
   static constexpr size_t MIN_EXPERIENCES_BEFORE_TRAINING = 1000;
-  static constexpr float PRIORITY_EPSILON = 1e-6f;
   float m_per_alpha = 0.6f;
   float m_per_beta = 0.4f;
 
-  float calculatePriority(float td_error) const;
-  float calculateImportanceWeight(float priority, float max_priority) const;
+  // Telemetry, shared by every agent in the process (see Core/Metrics.hpp).
+  float m_episodeReward = 0.0f;
+  Counter &m_stepCounter;
+  Counter &m_gradientUpdateCounter;
+  Gauge &m_replaySizeGauge;
+  Gauge &m_epsilonGauge;
+  Gauge &m_episodeRewardGauge;
+  Histogram &m_sampleLatency;
+  Histogram &m_tdErrors;
+  Histogram &m_episodeRewards;
+
+  uint64_t m_gradientUpdates = 0;
+  std::unique_ptr<CheckpointScheduler> m_checkpoints;
+  void maybeCheckpoint();
+
+  // Replay entries evaluated together: masked online Q-values of the states
+  // (row-major, one row per entry), double-DQN targets for the taken
+  // actions and the resulting TD errors.
+  struct TDBatch {
+    std::vector<size_t> indices;
+    std::vector<float> weights;
+    std::vector<float> states;
+    std::vector<float> nextStates;
+    std::vector<float> currentQ;
+    std::vector<float> nextQ;
+    std::vector<float> onlineNextQ;
+    std::vector<float> targets;
+    std::vector<float> tdErrors;
+  };
+  TDBatch m_trainBatch;
+  TDBatch m_sweepBatch;
+  void evaluateTDErrors(TDBatch &batch);
+  void refreshStalePriorities();
+
   void softUpdateTargetNetwork();
-  std::vector<float> getActionMask(const State &state) const;
+  float bootstrapDiscount(const Experience &exp) const;
+  std::array<float, ACTION_COUNT> getActionMask(const State &state) const;
 };
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <array>
-#include <vector>
 
 enum class ActionType {
   Noop,
@@ -15,6 +14,8 @@ enum class ActionType {
   MoveRightAttack
 };
 
+constexpr int ACTION_COUNT = static_cast<int>(ActionType::MoveRightAttack) + 1;
+
 inline const char *actionTypeToString(ActionType type) {
   switch (type) {
   case ActionType::Noop:
@@ -42,6 +43,24 @@ inline const char *actionTypeToString(ActionType type) {
 
 enum class Stance { Neutral, Aggressive, Defensive };
 
+// Features of a single observation, see RLAgent::encodeFrame.
+constexpr int FRAME_FEATURES = 16;
+// Observations stacked into the network input (oldest first), so the policy
+// sees motion and recent history rather than one snapshot. 1 disables it.
+constexpr int FRAME_STACK = 4;
+// Actions remembered per fighter, and how many of the newest are one-hot
+// encoded into the input (see ActionHistory).
+constexpr int ACTION_HISTORY = 10;
+constexpr int ENCODED_RECENT_ACTIONS = 3;
+constexpr int ACTION_HISTORY_FEATURES =
+    (ENCODED_RECENT_ACTIONS + 1) * ACTION_COUNT;
+// Length of State::features, i.e. the input width of the policy network:
+// the stacked frames, the action history blocks of the agent and of its
+// opponent, then the predicted distribution of the opponent's next action
+// (see OpponentModel).
+constexpr int STATE_FEATURES =
+    FRAME_FEATURES * FRAME_STACK + 2 * ACTION_HISTORY_FEATURES + ACTION_COUNT;
+
 struct State {
   float distanceToOpponent;
   float relativePositionX;
@@ -54,8 +73,7 @@ struct State {
   float opponentVelocityX;
   float opponentVelocityY;
   bool isCornered;
-  std::array<ActionType, 10> lastActions;
-  std::array<ActionType, 10> opponentLastActions;
+  ActionType opponentLastAction;
 
   float predictedDistance;
 
@@ -63,6 +81,11 @@ struct State {
 
   float myStamina;
   float myMaxStamina;
+
+  // Normalized network input: the last FRAME_STACK encoded frames, the
+  // action history blocks and the opponent prediction, filled in by
+  // RLAgent::observe.
+  std::array<float, STATE_FEATURES> features{};
 };
 
 struct Action {
@@ -95,24 +118,6 @@ struct StateNormalization {
   static constexpr float MAX_STAMINA = 500.0f;
   static constexpr float MAX_VELOCITY = 1000.0f;
   static constexpr float MAX_TIME = 10.0f;
-
-  static std::vector<float> getNormalizationRanges() {
-    return {
-        MAX_DISTANCE, // distanceToOpponent
-        MAX_DISTANCE, // relativePositionX
-        MAX_DISTANCE, // relativePositionY
-        1.0f,         // myHealth (already normalized)
-        1.0f,         // opponentHealth (already normalized)
-        MAX_TIME,     // timeSinceLastAction
-        MAX_DISTANCE, MAX_DISTANCE, MAX_DISTANCE, MAX_DISTANCE, // radar values
-        MAX_VELOCITY, // opponentVelocityX
-        MAX_VELOCITY, // opponentVelocityY
-        1.0f,         // isCornered (already binary)
-        1.0f,         // currentStance (already normalized)
-        1.0f,         // myStamina (already normalized)
-        1.0f          // maxStamina (already normalized)
-    };
-  }
 };
 
 struct Experience {
@@ -120,6 +125,10 @@ struct Experience {
   Action action;
   float reward;
   State nextState;
+  // Environment steps folded into `reward` (n-step returns); the learner
+  // bootstraps from nextState with gamma^steps unless the round ended.
+  int steps = 1;
+  bool done = false;
 };
 
 struct BattleStyle {
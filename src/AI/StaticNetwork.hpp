@@ -0,0 +1,224 @@
+#pragma once
+#include "NeuralNetwork.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+// Layer descriptor for StaticNetwork: output width, activation and whether
+// the pre-activations go through layer normalization.
+template <int Outputs, ActivationType Activation, bool Normalize = false>
+struct Dense {
+  static constexpr int outputs = Outputs;
+  static constexpr ActivationType activation = Activation;
+  static constexpr bool normalize = Normalize;
+};
+
+// Fully connected layer with compile-time shape.
+//
+// Weights are stored input-major (W[in][out], the transpose of Layer) so the
+// inner loop runs across outputs: a constant trip count with no reduction,
+// which the compiler unrolls and vectorizes without -ffast-math.
+template <int In, int Out, ActivationType Act, bool Norm = false>
+struct StaticDense {
+  static constexpr int inputs = In;
+  static constexpr int outputs = Out;
+  static constexpr ActivationType activation = Act;
+  static constexpr bool normalize = Norm;
+
+  alignas(32) std::array<float, In * Out> weights{};
+  alignas(32) std::array<float, Out> biases{};
+
+  // Layer-norm parameters, empty unless Norm.
+  alignas(32) std::array<float, Norm ? Out : 0> gamma{};
+  alignas(32) std::array<float, Norm ? Out : 0> beta{};
+  float epsilon = 1e-5f;
+  float runningMean = 0.0f;
+  float runningVar = 1.0f;
+  bool useRunningStats = false;
+
+  void forward(const float *__restrict input,
+               float *__restrict output) const {
+    for (int o = 0; o < Out; ++o)
+      output[o] = biases[o];
+    for (int i = 0; i < In; ++i) {
+      const float x = input[i];
+      const float *column = &weights[i * Out];
+      for (int o = 0; o < Out; ++o)
+        output[o] += x * column[o];
+    }
+    if constexpr (Norm) {
+      float mean = runningMean;
+      float var = runningVar;
+      if (!useRunningStats)
+        LayerNormalization::moments(output, Out, mean, var);
+      LayerNormalization::scaleShift(output, Out, gamma.data(), beta.data(),
+                                     mean, 1.0f / std::sqrt(var + epsilon),
+                                     nullptr);
+    }
+    activateBuffer(output, output, Out, Act);
+  }
+};
+
+namespace detail {
+template <int In, typename... Layers> struct LayerChain;
+
+template <int In> struct LayerChain<In> {
+  using type = std::tuple<>;
+  static constexpr int outputs = In;
+  static constexpr int maxWidth = In;
+};
+
+template <int In, typename L, typename... Rest>
+struct LayerChain<In, L, Rest...> {
+  using Head = StaticDense<In, L::outputs, L::activation, L::normalize>;
+  using Tail = LayerChain<L::outputs, Rest...>;
+  using type = decltype(std::tuple_cat(std::declval<std::tuple<Head>>(),
+                                       std::declval<typename Tail::type>()));
+  static constexpr int outputs = Tail::outputs;
+  static constexpr int maxWidth =
+      In > Tail::maxWidth ? In : Tail::maxWidth;
+};
+} // namespace detail
+
+// Inference-only MLP whose shape is fixed at compile time, e.g.
+//
+//   StaticNetwork<14, Dense<64, ActivationType::Sigmoid, true>,
+//                 Dense<9, ActivationType::None>>
+//
+// Parameters live inline in aligned std::arrays and forward() uses stack
+// scratch, so evaluating it never allocates. Weights are exchanged with the
+// trainable NeuralNetwork through loadFrom()/toNeuralNetwork(), so models are
+// saved and loaded through the NeuralNetwork formats (Checkpoint, JSON).
+template <int In, typename... Layers> class StaticNetwork {
+  static_assert(sizeof...(Layers) > 0, "StaticNetwork needs a layer");
+  using Chain = detail::LayerChain<In, Layers...>;
+
+public:
+  static constexpr int inputs = In;
+  static constexpr int outputs = Chain::outputs;
+  static constexpr size_t numLayers = sizeof...(Layers);
+
+  using Input = std::array<float, In>;
+  using Output = std::array<float, outputs>;
+
+  void forward(const float *input, float *output) const {
+    alignas(32) std::array<float, Chain::maxWidth> a;
+    alignas(32) std::array<float, Chain::maxWidth> b;
+    run<0>(input, a.data(), b.data(), output);
+  }
+
+  Output forward(const Input &input) const {
+    Output output;
+    forward(input.data(), output.data());
+    return output;
+  }
+
+  // True when `network` has exactly this shape, these activations and the
+  // same normalized layers.
+  static bool matches(const NeuralNetwork &network) {
+    const auto &layers = network.getLayers();
+    return layers.size() == numLayers &&
+           matchesLayers(layers, std::make_index_sequence<numLayers>());
+  }
+
+  // Copies the parameters of a compatible network. Leaves this network
+  // untouched and returns false on a shape mismatch.
+  bool loadFrom(const NeuralNetwork &network) {
+    if (!matches(network))
+      return false;
+    loadLayers(network.getLayers(), std::make_index_sequence<numLayers>());
+    return true;
+  }
+
+  NeuralNetwork toNeuralNetwork() const {
+    NeuralNetwork network(In);
+    storeLayers(network, std::make_index_sequence<numLayers>());
+    return network;
+  }
+
+  template <size_t I> const auto &layer() const {
+    return std::get<I>(m_layers);
+  }
+  template <size_t I> auto &layer() { return std::get<I>(m_layers); }
+
+private:
+  typename Chain::type m_layers;
+
+  // Ping-pongs between two scratch buffers; the last layer writes straight
+  // into the caller's output.
+  template <size_t I>
+  void run(const float *input, float *next, float *spare,
+           float *output) const {
+    const auto &current = std::get<I>(m_layers);
+    if constexpr (I + 1 == numLayers) {
+      current.forward(input, output);
+    } else {
+      current.forward(input, next);
+      run<I + 1>(next, spare, next, output);
+    }
+  }
+
+  template <typename L> static bool matchesLayer(const Layer &layer) {
+    return layer.inputSize == L::inputs && layer.outputSize == L::outputs &&
+           layer.activation == L::activation &&
+           layer.use_normalization == L::normalize;
+  }
+
+  template <size_t... I>
+  static bool matchesLayers(const std::vector<Layer> &layers,
+                            std::index_sequence<I...>) {
+    return (matchesLayer<std::tuple_element_t<I, typename Chain::type>>(
+                layers[I]) &&
+            ...);
+  }
+
+  template <typename L> static void loadLayer(L &target, const Layer &source) {
+    for (int o = 0; o < L::outputs; ++o) {
+      for (int i = 0; i < L::inputs; ++i)
+        target.weights[i * L::outputs + o] = source.weight(o, i);
+      target.biases[o] = source.biases[o];
+    }
+    if constexpr (L::normalize) {
+      const LayerNormalization &norm = source.normalization;
+      std::copy(norm.gamma.begin(), norm.gamma.end(), target.gamma.begin());
+      std::copy(norm.beta.begin(), norm.beta.end(), target.beta.begin());
+      target.epsilon = norm.epsilon;
+      target.runningMean = norm.running_mean;
+      target.runningVar = norm.running_var;
+      target.useRunningStats = norm.use_running_stats;
+    }
+  }
+
+  template <size_t... I>
+  void loadLayers(const std::vector<Layer> &layers, std::index_sequence<I...>) {
+    (loadLayer(std::get<I>(m_layers), layers[I]), ...);
+  }
+
+  template <typename L>
+  static void storeLayer(NeuralNetwork &network, const L &source) {
+    network.addLayer(L::outputs, L::activation, L::normalize);
+    std::vector<float> weights(static_cast<size_t>(L::inputs) * L::outputs);
+    for (int o = 0; o < L::outputs; ++o)
+      for (int i = 0; i < L::inputs; ++i)
+        weights[o * L::inputs + i] = source.weights[i * L::outputs + o];
+    network.setLayerParameters(
+        network.numLayers() - 1, weights,
+        std::vector<float>(source.biases.begin(), source.biases.end()));
+    if constexpr (L::normalize) {
+      network.setNormalizationParameters(
+          network.numLayers() - 1,
+          std::vector<float>(source.gamma.begin(), source.gamma.end()),
+          std::vector<float>(source.beta.begin(), source.beta.end()),
+          source.runningMean, source.runningVar);
+      if (source.useRunningStats)
+        network.setNormalizationFrozen(true);
+    }
+  }
+
+  template <size_t... I>
+  void storeLayers(NeuralNetwork &network, std::index_sequence<I...>) const {
+    (storeLayer(network, std::get<I>(m_layers)), ...);
+  }
+};
@@ -57,5 +57,25 @@ struct Config {
 
     float repeatActionPenalty = -20.0f;
     float wellTimedBlockBonus = 10.0f;
+
+    // Rewards summed per stored transition (n-step returns); 1 is plain
+    // one-step Q-learning.
+    int nStepReturns = 3;
+    // Replay entries whose priorities are recomputed after each gradient
+    // update, sweeping the buffer oldest-refreshed first; 0 disables it.
+    int priorityRefreshBatch = 32;
+
+    // Gradient updates between Polyak updates of the target network.
+    int targetUpdateInterval = 1;
+
+    // Per-tick decay of the opponent model's n-gram counts.
+    float opponentModelDecay = 0.999f;
+
+    // Background checkpoints of both Q-networks; a trigger of 0 is disabled.
+    // Off by default: they go to checkpoints/ under the working directory.
+    bool autoCheckpoint = false;
+    int checkpointEveryUpdates = 5000;
+    float checkpointEveryMinutes = 10.0f;
+    int checkpointsToKeep = 3;
   } ai;
 };
@@ -33,13 +33,20 @@ public:
       Action lastAction = agent.lastAction();
       ImGui::Text("Last Action: %s", actionTypeToString(lastAction.type));
 
-      for (auto action : agent.getActionHistory()) {
-        ImGui::Text("%s", actionTypeToString(action));
+      const ActionHistory &history = agent.getActionHistory();
+      for (size_t i = 0; i < history.size(); ++i) {
+        ImGui::Text("%s", actionTypeToString(history[i]));
       }
     }
     if (ImGui::CollapsingHeader("Opponent Actions:")) {
-      for (auto action : agent.getOpponentActionHistory()) {
-        ImGui::Text("%s", actionTypeToString(action));
+      const OpponentModel &model = agent.getOpponentModel();
+      ImGui::Text("Predicted next: %s (%.0f%%), attack %.0f%%",
+                  actionTypeToString(model.mostLikely()),
+                  model.probability(model.mostLikely()) * 100.0f,
+                  model.attackProbability() * 100.0f);
+      const ActionHistory &history = agent.getOpponentActionHistory();
+      for (size_t i = 0; i < history.size(); ++i) {
+        ImGui::Text("%s", actionTypeToString(history[i]));
       }
     }
 
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// Single-writer, multi-reader double buffer with RCU-style publication.
+//
+// Readers pin the current slot with read() and keep it for as long as the
+// returned guard lives; pinning is a couple of atomic operations and never
+// blocks (it retries only if a publish lands in between). The writer fills
+// back() and makes it current with publish(), which bumps the epoch. Before
+// handing out the back slot again, back() waits for the readers still pinned
+// on it to leave -- the grace period -- so a reader never sees a torn or
+// half-written value.
+//
+// Readers should hold a pin for one short operation (a forward pass, one UI
+// frame), not across publishes, or the writer will spin in back().
+template <typename T> class DoubleBuffered {
+public:
+  class ReadGuard {
+  public:
+    ReadGuard(const DoubleBuffered *owner, int slot, uint64_t epoch)
+        : m_owner(owner), m_slot(slot), m_epoch(epoch) {}
+    ~ReadGuard() {
+      if (m_owner)
+        m_owner->m_readers[m_slot].fetch_sub(1, std::memory_order_release);
+    }
+    ReadGuard(ReadGuard &&other) noexcept
+        : m_owner(other.m_owner), m_slot(other.m_slot),
+          m_epoch(other.m_epoch) {
+      other.m_owner = nullptr;
+    }
+    ReadGuard(const ReadGuard &) = delete;
+    ReadGuard &operator=(const ReadGuard &) = delete;
+    ReadGuard &operator=(ReadGuard &&) = delete;
+
+    const T &operator*() const { return m_owner->m_slots[m_slot]; }
+    const T *operator->() const { return &m_owner->m_slots[m_slot]; }
+    // Number of publishes that preceded this value.
+    uint64_t epoch() const { return m_epoch; }
+
+  private:
+    const DoubleBuffered *m_owner;
+    int m_slot;
+    uint64_t m_epoch;
+  };
+
+  DoubleBuffered() = default;
+  DoubleBuffered(const DoubleBuffered &) = delete;
+  DoubleBuffered &operator=(const DoubleBuffered &) = delete;
+
+  ReadGuard read() const {
+    while (true) {
+      uint64_t epoch = m_epoch.load(std::memory_order_seq_cst);
+      int slot = static_cast<int>(epoch & 1);
+      m_readers[slot].fetch_add(1, std::memory_order_seq_cst);
+      // If a publish raced with the pin, the writer may already be refilling
+      // this slot; drop it and pin the new one.
+      if (m_epoch.load(std::memory_order_seq_cst) == epoch)
+        return ReadGuard(this, slot, epoch);
+      m_readers[slot].fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  // Writer only. The slot holds whatever was published two epochs ago.
+  T &back() {
+    int slot = static_cast<int>((m_epoch.load(std::memory_order_relaxed) + 1) &
+                                1);
+    // seq_cst pairs with the reader's increment and epoch re-check in read():
+    // either the reader sees the publish and backs off, or this load sees
+    // its pin. Acquire alone would allow both to miss each other.
+    while (m_readers[slot].load(std::memory_order_seq_cst) != 0)
+      std::this_thread::yield();
+    return m_slots[slot];
+  }
+
+  // Writer only: makes the last back() current.
+  void publish() { m_epoch.fetch_add(1, std::memory_order_seq_cst); }
+
+  uint64_t epoch() const { return m_epoch.load(std::memory_order_acquire); }
+
+private:
+  T m_slots[2];
+  std::atomic<uint64_t> m_epoch{0};
+  mutable std::atomic<uint32_t> m_readers[2] = {};
+};
@@ -0,0 +1,56 @@
+#include "FrameArena.hpp"
+#include <algorithm>
+
+FrameArena::FrameArena(size_t capacity)
+    : m_block(new std::byte[capacity]), m_capacity(capacity) {}
+
+FrameArena::~FrameArena() { rewind(0, 0); }
+
+FrameArena &FrameArena::local() {
+  static thread_local FrameArena arena;
+  return arena;
+}
+
+void FrameArena::reset() {
+  rewind(0, 0);
+  if (m_spillCount > 0) {
+    // Room for the whole frame plus slack for alignment padding.
+    m_capacity = std::max(m_capacity * 2, m_frameHigh + m_frameHigh / 4);
+    m_block.reset(new std::byte[m_capacity]);
+  }
+  m_frameHigh = 0;
+  m_allocations = 0;
+  m_spillCount = 0;
+}
+
+void FrameArena::rewind(size_t offset, size_t spills) {
+  m_offset = offset;
+  while (m_spills.size() > spills) {
+    const Spill &spill = m_spills.back();
+    std::pmr::new_delete_resource()->deallocate(spill.pointer, spill.bytes,
+                                                spill.alignment);
+    m_spillBytes -= spill.bytes;
+    m_spills.pop_back();
+  }
+}
+
+void *FrameArena::do_allocate(size_t bytes, size_t alignment) {
+  ++m_allocations;
+  const uintptr_t base = reinterpret_cast<uintptr_t>(m_block.get());
+  const uintptr_t aligned =
+      (base + m_offset + alignment - 1) & ~(uintptr_t{alignment} - 1);
+  const size_t begin = aligned - base;
+  void *pointer;
+  if (begin + bytes <= m_capacity) {
+    m_offset = begin + bytes;
+    pointer = m_block.get() + begin;
+  } else {
+    pointer = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    m_spills.push_back(Spill{pointer, bytes, alignment});
+    m_spillBytes += bytes;
+    ++m_spillCount;
+  }
+  m_frameHigh = std::max(m_frameHigh, used());
+  m_peak = std::max(m_peak, m_frameHigh);
+  return pointer;
+}
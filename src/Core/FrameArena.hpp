@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Bump allocator for data that lives at most one frame: scratch vectors of
+// the agent and the networks, the tick's combat events, and so on. Use it
+// through std::pmr containers, e.g.
+//
+//   std::pmr::vector<float> scratch(n, &FrameArena::local());
+//
+// Allocation bumps an offset into one block and deallocation does nothing;
+// reset() releases everything at once. A frame that outgrows the block
+// spills to the heap, and the next reset() grows the block to that frame's
+// size, so steady-state frames never reach the global allocator.
+//
+// Each thread has its own arena (local()). The main loop resets its arena
+// at the end of every frame; any other thread that uses its arena must
+// reset it the same way. Code that may run outside a frame, like the
+// networks' forward passes, wraps its scratch in a Scope instead.
+class FrameArena : public std::pmr::memory_resource {
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 256 * 1024;
+
+  explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+  ~FrameArena() override;
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  // The calling thread's arena.
+  static FrameArena &local();
+
+  // Releases every allocation. Nothing allocated before may be used after.
+  void reset();
+
+  // Releases, on destruction, whatever was allocated since construction.
+  class Scope {
+  public:
+    explicit Scope(FrameArena &arena = local())
+        : m_arena(arena), m_offset(arena.m_offset),
+          m_spills(arena.m_spills.size()) {}
+    ~Scope() { m_arena.rewind(m_offset, m_spills); }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    FrameArena &m_arena;
+    size_t m_offset;
+    size_t m_spills;
+  };
+
+  size_t capacity() const { return m_capacity; }
+  // Bytes currently handed out, spills included.
+  size_t used() const { return m_offset + m_spillBytes; }
+  // Largest used() since the last reset(), and over the arena's lifetime.
+  size_t frameHigh() const { return m_frameHigh; }
+  size_t peak() const { return m_peak; }
+  // Allocations since the last reset(), and how many of them spilled.
+  uint64_t allocations() const { return m_allocations; }
+  uint64_t spills() const { return m_spillCount; }
+
+private:
+  struct Spill {
+    void *pointer;
+    size_t bytes;
+    size_t alignment;
+  };
+
+  std::unique_ptr<std::byte[]> m_block;
+  size_t m_capacity;
+  size_t m_offset = 0;
+  size_t m_frameHigh = 0;
+  size_t m_peak = 0;
+  uint64_t m_allocations = 0;
+  uint64_t m_spillCount = 0;
+  // Live heap allocations that did not fit in the block.
+  std::vector<Spill> m_spills;
+  size_t m_spillBytes = 0;
+
+  void rewind(size_t offset, size_t spills);
+
+  void *do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void *, size_t, size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+};
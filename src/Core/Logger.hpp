@@ -1,14 +1,17 @@
 #pragma once
 
+#include "Core/MemoryTracker.hpp"
 #include <cstdarg>
 #include <cstdio>
 #include <ctime>
 #include <deque>
 #include <iostream>
+#include <memory_resource>
 #include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 class Logger {
 
@@ -33,38 +36,39 @@ public:
     std::lock_guard<std::mutex> lock(logger.m_mutex);
   }
 
-  static const std::deque<std::pair<LogLevel, std::string>> &messages() {
+  static const std::pmr::deque<std::pair<LogLevel, std::pmr::string>> &
+  messages() {
     return get().m_messages;
   }
   static void clear_messages() { get().m_messages.clear(); }
 
   template <typename... Args>
-  static void trace(const std::string &format_str, Args &&...args) {
+  static void trace(std::string_view format_str, Args &&...args) {
     get().log(LogLevel::Trace, format_str, std::forward<Args>(args)...);
   }
 
   template <typename... Args>
-  static void debug(const std::string &format_str, Args &&...args) {
+  static void debug(std::string_view format_str, Args &&...args) {
     get().log(LogLevel::Debug, format_str, std::forward<Args>(args)...);
   }
 
   template <typename... Args>
-  static void info(const std::string &format_str, Args &&...args) {
+  static void info(std::string_view format_str, Args &&...args) {
     get().log(LogLevel::Info, format_str, std::forward<Args>(args)...);
   }
 
   template <typename... Args>
-  static void warn(const std::string &format_str, Args &&...args) {
+  static void warn(std::string_view format_str, Args &&...args) {
     get().log(LogLevel::Warn, format_str, std::forward<Args>(args)...);
   }
 
   template <typename... Args>
-  static void error(const std::string &format_str, Args &&...args) {
+  static void error(std::string_view format_str, Args &&...args) {
     get().log(LogLevel::Error, format_str, std::forward<Args>(args)...);
   }
 
   template <typename... Args>
-  static void fatal(const std::string &format_str, Args &&...args) {
+  static void fatal(std::string_view format_str, Args &&...args) {
     std::string message =
         get().format_exception_message(format_str, std::forward<Args>(args)...);
     get().log(LogLevel::Fatal, message);
@@ -73,7 +77,7 @@ public:
   }
 
   template <typename... Args>
-  static void fatal(const std::exception &ex, const std::string &format_str,
+  static void fatal(const std::exception &ex, std::string_view format_str,
                     Args &&...args) {
     std::string message =
         get().format_exception_message(format_str, std::forward<Args>(args)...);
@@ -88,27 +92,21 @@ private:
     return instance;
   }
 
+  // Takes a view so that a filtered message costs no allocation; nothing is
+  // copied or formatted below the configured level.
   template <typename... Args>
-  void log(LogLevel level, const std::string &format_str, Args &&...args) {
+  void log(LogLevel level, std::string_view format_str, Args &&...args) {
     if (level < m_config.level)
       return;
 
-    std::string message;
-    if constexpr (sizeof...(args) > 0) {
-      constexpr size_t BUFFER_SIZE = 1024;
-      char buffer[BUFFER_SIZE];
-      int ret = std::snprintf(buffer, BUFFER_SIZE, format_str.c_str(), args...);
-      message = (ret >= 0 && static_cast<size_t>(ret) < BUFFER_SIZE)
-                    ? buffer
-                    : format_str;
-    } else {
-      message = format_str;
-    }
+    MemoryTracker::Scope memoryScope(MemorySubsystem::Logging);
+    std::string message =
+        format_exception_message(format_str, std::forward<Args>(args)...);
 
     std::string formatted_message = format_message(level, message);
     std::lock_guard<std::mutex> lock(m_mutex);
 
-    m_messages.push_back({level, formatted_message});
+    m_messages.emplace_back(level, formatted_message);
 
     const size_t MAX_LOG_SIZE = 1000;
     if (m_messages.size() > MAX_LOG_SIZE) {
@@ -183,18 +181,15 @@ private:
   }
 
   template <typename... Args>
-  std::string format_exception_message(const std::string &format_str,
+  std::string format_exception_message(std::string_view format_str,
                                        Args &&...args) {
-    std::string message;
+    std::string message(format_str);
     if constexpr (sizeof...(args) > 0) {
       constexpr size_t BUFFER_SIZE = 1024;
       char buffer[BUFFER_SIZE];
-      int ret = std::snprintf(buffer, BUFFER_SIZE, format_str.c_str(), args...);
-      message = (ret >= 0 && static_cast<size_t>(ret) < BUFFER_SIZE)
-                    ? buffer
-                    : format_str;
-    } else {
-      message = format_str;
+      int ret = std::snprintf(buffer, BUFFER_SIZE, message.c_str(), args...);
+      if (ret >= 0 && static_cast<size_t>(ret) < BUFFER_SIZE)
+        message = buffer;
     }
     return message;
   }
@@ -210,5 +205,6 @@ private:
 
   LoggerConfig m_config;
   std::mutex m_mutex;
-  std::deque<std::pair<LogLevel, std::string>> m_messages;
+  std::pmr::deque<std::pair<LogLevel, std::pmr::string>> m_messages{
+      MemoryTracker::resource(MemorySubsystem::Logging)};
 };
@@ -0,0 +1,250 @@
+#include "MemoryTracker.hpp"
+#include "Core/Logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+struct Totals {
+  std::atomic<int64_t> liveBytes{0};
+  std::atomic<int64_t> peakBytes{0};
+  std::atomic<uint64_t> allocations{0};
+};
+
+// Constant-initialized, so usable by operator new before main().
+Totals g_totals[MEMORY_SUBSYSTEM_COUNT];
+thread_local MemorySubsystem t_current = MemorySubsystem::Other;
+
+// Main-thread state for endFrame().
+uint64_t g_frameStart[MEMORY_SUBSYSTEM_COUNT];
+uint64_t g_frameAllocations[MEMORY_SUBSYSTEM_COUNT];
+
+class TrackedResource : public std::pmr::memory_resource {
+public:
+  explicit TrackedResource(MemorySubsystem subsystem)
+      : m_subsystem(subsystem) {}
+
+private:
+  MemorySubsystem m_subsystem;
+
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    // With the hook installed, operator new does the accounting.
+    MemoryTracker::Scope scope(m_subsystem);
+    void *pointer =
+        std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    if (!MemoryTracker::HOOKED)
+      MemoryTracker::recordAllocation(m_subsystem, bytes);
+    return pointer;
+  }
+
+  void do_deallocate(void *pointer, size_t bytes, size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    if (!MemoryTracker::HOOKED)
+      MemoryTracker::recordDeallocation(m_subsystem, bytes);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+};
+} // namespace
+
+const char *memorySubsystemName(MemorySubsystem subsystem) {
+  switch (subsystem) {
+  case MemorySubsystem::Other:
+    return "Other";
+  case MemorySubsystem::AI:
+    return "AI";
+  case MemorySubsystem::Animation:
+    return "Animation";
+  case MemorySubsystem::Rendering:
+    return "Rendering";
+  case MemorySubsystem::Logging:
+    return "Logging";
+  case MemorySubsystem::Resources:
+    return "Resources";
+  }
+  return "Unknown";
+}
+
+MemoryTracker::Scope::Scope(MemorySubsystem subsystem)
+    : m_previous(t_current) {
+  t_current = subsystem;
+}
+
+MemoryTracker::Scope::~Scope() { t_current = m_previous; }
+
+MemorySubsystem MemoryTracker::current() { return t_current; }
+
+std::pmr::memory_resource *
+MemoryTracker::resource(MemorySubsystem subsystem) {
+  static TrackedResource resources[MEMORY_SUBSYSTEM_COUNT] = {
+      TrackedResource(MemorySubsystem::Other),
+      TrackedResource(MemorySubsystem::AI),
+      TrackedResource(MemorySubsystem::Animation),
+      TrackedResource(MemorySubsystem::Rendering),
+      TrackedResource(MemorySubsystem::Logging),
+      TrackedResource(MemorySubsystem::Resources),
+  };
+  return &resources[static_cast<int>(subsystem)];
+}
+
+void MemoryTracker::recordAllocation(MemorySubsystem subsystem,
+                                     size_t bytes) {
+  Totals &totals = g_totals[static_cast<int>(subsystem)];
+  const int64_t live =
+      totals.liveBytes.fetch_add(static_cast<int64_t>(bytes),
+                                 std::memory_order_relaxed) +
+      static_cast<int64_t>(bytes);
+  int64_t peak = totals.peakBytes.load(std::memory_order_relaxed);
+  while (live > peak && !totals.peakBytes.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed))
+    ;
+  totals.allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryTracker::recordDeallocation(MemorySubsystem subsystem,
+                                       size_t bytes) {
+  g_totals[static_cast<int>(subsystem)].liveBytes.fetch_sub(
+      static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
+void MemoryTracker::endFrame() {
+  for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+    const uint64_t allocations =
+        g_totals[i].allocations.load(std::memory_order_relaxed);
+    g_frameAllocations[i] = allocations - g_frameStart[i];
+    g_frameStart[i] = allocations;
+  }
+}
+
+MemoryTracker::Stats MemoryTracker::stats(MemorySubsystem subsystem) {
+  const int i = static_cast<int>(subsystem);
+  Stats stats;
+  stats.liveBytes = g_totals[i].liveBytes.load(std::memory_order_relaxed);
+  stats.peakBytes = g_totals[i].peakBytes.load(std::memory_order_relaxed);
+  stats.allocations = g_totals[i].allocations.load(std::memory_order_relaxed);
+  stats.frameAllocations = g_frameAllocations[i];
+  return stats;
+}
+
+void MemoryTracker::dump() {
+  Logger::info(HOOKED ? "Memory by subsystem (all heap allocations):"
+                      : "Memory by subsystem (tagged resources only):");
+  for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+    const auto subsystem = static_cast<MemorySubsystem>(i);
+    const Stats s = stats(subsystem);
+    Logger::info("  %-10s live %10lld B  peak %10lld B  allocations %llu",
+                 memorySubsystemName(subsystem),
+                 static_cast<long long>(s.liveBytes),
+                 static_cast<long long>(s.peakBytes),
+                 static_cast<unsigned long long>(s.allocations));
+  }
+}
+
+#if defined(MEMORY_TRACKING)
+namespace {
+// Sits right before every block handed out by the operators below.
+struct BlockHeader {
+  void *raw;
+  size_t bytes;
+  MemorySubsystem subsystem;
+};
+
+void *trackedAllocate(size_t bytes, size_t alignment) noexcept {
+  alignment = std::max(alignment, alignof(std::max_align_t));
+  void *raw = std::malloc(sizeof(BlockHeader) + alignment - 1 + bytes);
+  if (!raw)
+    return nullptr;
+  const uintptr_t user =
+      (reinterpret_cast<uintptr_t>(raw) + sizeof(BlockHeader) + alignment -
+       1) &
+      ~(uintptr_t{alignment} - 1);
+  BlockHeader *header = reinterpret_cast<BlockHeader *>(user) - 1;
+  *header = BlockHeader{raw, bytes, t_current};
+  MemoryTracker::recordAllocation(header->subsystem, bytes);
+  return reinterpret_cast<void *>(user);
+}
+
+void *trackedNew(size_t bytes, size_t alignment) {
+  while (true) {
+    if (void *pointer = trackedAllocate(bytes, alignment))
+      return pointer;
+    std::new_handler handler = std::get_new_handler();
+    if (!handler)
+      throw std::bad_alloc();
+    handler();
+  }
+}
+
+void trackedFree(void *pointer) noexcept {
+  if (!pointer)
+    return;
+  const BlockHeader *header = static_cast<BlockHeader *>(pointer) - 1;
+  MemoryTracker::recordDeallocation(header->subsystem, header->bytes);
+  std::free(header->raw);
+}
+} // namespace
+
+void *operator new(size_t bytes) {
+  return trackedNew(bytes, alignof(std::max_align_t));
+}
+void *operator new[](size_t bytes) {
+  return trackedNew(bytes, alignof(std::max_align_t));
+}
+void *operator new(size_t bytes, std::align_val_t alignment) {
+  return trackedNew(bytes, static_cast<size_t>(alignment));
+}
+void *operator new[](size_t bytes, std::align_val_t alignment) {
+  return trackedNew(bytes, static_cast<size_t>(alignment));
+}
+void *operator new(size_t bytes, const std::nothrow_t &) noexcept {
+  return trackedAllocate(bytes, alignof(std::max_align_t));
+}
+void *operator new[](size_t bytes, const std::nothrow_t &) noexcept {
+  return trackedAllocate(bytes, alignof(std::max_align_t));
+}
+void *operator new(size_t bytes, std::align_val_t alignment,
+                   const std::nothrow_t &) noexcept {
+  return trackedAllocate(bytes, static_cast<size_t>(alignment));
+}
+void *operator new[](size_t bytes, std::align_val_t alignment,
+                     const std::nothrow_t &) noexcept {
+  return trackedAllocate(bytes, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void *pointer) noexcept { trackedFree(pointer); }
+void operator delete(void *pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void *pointer, size_t) noexcept {
+  trackedFree(pointer);
+}
+void operator delete(void *pointer, std::align_val_t) noexcept {
+  trackedFree(pointer);
+}
+void operator delete[](void *pointer, std::align_val_t) noexcept {
+  trackedFree(pointer);
+}
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept {
+  trackedFree(pointer);
+}
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept {
+  trackedFree(pointer);
+}
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {
+  trackedFree(pointer);
+}
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept {
+  trackedFree(pointer);
+}
+void operator delete(void *pointer, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+  trackedFree(pointer);
+}
+void operator delete[](void *pointer, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+  trackedFree(pointer);
+}
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+enum class MemorySubsystem : uint8_t {
+  Other, // anything allocated outside a Scope
+  AI,
+  Animation,
+  Rendering,
+  Logging,
+  Resources,
+};
+constexpr int MEMORY_SUBSYSTEM_COUNT =
+    static_cast<int>(MemorySubsystem::Resources) + 1;
+
+const char *memorySubsystemName(MemorySubsystem subsystem);
+
+// Heap usage per subsystem: live bytes, their high-water mark, and how many
+// allocations each subsystem makes per frame.
+//
+// Two sources feed it. Building with MEMORY_TRACKING defined (make
+// ENABLE_MEMORY_TRACKING=1) replaces the global operator new/delete, and
+// every allocation is charged to the subsystem of the innermost Scope on the
+// allocating thread. Without it only the tagged memory resources from
+// resource() are counted, so the panel still shows those subsystems. Either
+// way Resources also carries the decoded size of loaded textures, which live
+// in the renderer rather than on the heap.
+//
+// Counters are relaxed atomics, safe to update from any thread.
+class MemoryTracker {
+public:
+#if defined(MEMORY_TRACKING)
+  static constexpr bool HOOKED = true;
+#else
+  static constexpr bool HOOKED = false;
+#endif
+
+  struct Stats {
+    int64_t liveBytes = 0;
+    int64_t peakBytes = 0;
+    uint64_t allocations = 0;
+    // Allocations made during the last frame closed by endFrame().
+    uint64_t frameAllocations = 0;
+  };
+
+  // Charges the calling thread's allocations to `subsystem` until destroyed.
+  class Scope {
+  public:
+    explicit Scope(MemorySubsystem subsystem);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    MemorySubsystem m_previous;
+  };
+
+  // The subsystem allocations on this thread are charged to.
+  static MemorySubsystem current();
+
+  // A memory resource over new/delete that charges `subsystem` whatever
+  // thread or Scope uses it. Valid for the lifetime of the program.
+  static std::pmr::memory_resource *resource(MemorySubsystem subsystem);
+
+  // For memory the global hook cannot see, like texture pixels.
+  static void recordAllocation(MemorySubsystem subsystem, size_t bytes);
+  static void recordDeallocation(MemorySubsystem subsystem, size_t bytes);
+
+  // Latches the per-frame allocation counts. Main thread, once per frame.
+  static void endFrame();
+
+  // Main thread only (frameAllocations is not atomic).
+  static Stats stats(MemorySubsystem subsystem);
+
+  // Logs one line per subsystem.
+  static void dump();
+};
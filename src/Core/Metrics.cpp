@@ -0,0 +1,303 @@
+#include "Metrics.hpp"
+#include "Core/Logger.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace {
+// C++17 has no fetch_add/fetch_min for atomic<double>, so fall back to CAS.
+void atomicAdd(std::atomic<double> &target, double value) {
+  double current = target.load(std::memory_order_relaxed);
+  while (!target.compare_exchange_weak(current, current + value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+void atomicMin(std::atomic<double> &target, double value) {
+  double current = target.load(std::memory_order_relaxed);
+  while (value < current &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+void atomicMax(std::atomic<double> &target, double value) {
+  double current = target.load(std::memory_order_relaxed);
+  while (value > current &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+const char BINARY_MAGIC[4] = {'F', 'G', 'M', 'T'};
+const uint32_t BINARY_VERSION = 1;
+} // namespace
+
+Histogram::Histogram(std::vector<double> upperBounds)
+    : m_bounds(std::move(upperBounds)),
+      m_buckets(new std::atomic<uint64_t>[m_bounds.size() + 1]),
+      m_min(std::numeric_limits<double>::infinity()),
+      m_max(-std::numeric_limits<double>::infinity()) {
+  std::sort(m_bounds.begin(), m_bounds.end());
+  for (size_t i = 0; i < bucketCount(); ++i)
+    m_buckets[i].store(0, std::memory_order_relaxed);
+}
+
+std::vector<double> Histogram::exponentialBounds(double start, double factor,
+                                                 int count) {
+  std::vector<double> bounds;
+  bounds.reserve(count);
+  double bound = start;
+  for (int i = 0; i < count; ++i) {
+    bounds.push_back(bound);
+    bound *= factor;
+  }
+  return bounds;
+}
+
+std::vector<double> Histogram::linearBounds(double start, double width,
+                                            int count) {
+  std::vector<double> bounds;
+  bounds.reserve(count);
+  for (int i = 0; i < count; ++i)
+    bounds.push_back(start + width * i);
+  return bounds;
+}
+
+void Histogram::observe(double value) {
+  size_t index = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) -
+                 m_bounds.begin();
+  m_buckets[index].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  atomicAdd(m_sum, value);
+  atomicMin(m_min, value);
+  atomicMax(m_max, value);
+}
+
+double Histogram::mean() const {
+  uint64_t n = count();
+  return n > 0 ? sum() / n : 0.0;
+}
+
+double Histogram::quantile(double q) const {
+  uint64_t n = count();
+  if (n == 0)
+    return 0.0;
+
+  double rank = std::clamp(q, 0.0, 1.0) * n;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < bucketCount(); ++i) {
+    uint64_t inBucket = bucketValue(i);
+    if (inBucket == 0 || seen + inBucket < rank) {
+      seen += inBucket;
+      continue;
+    }
+    double lower = i == 0 ? min() : m_bounds[i - 1];
+    double upper = i < m_bounds.size() ? m_bounds[i] : max();
+    double fraction = (rank - seen) / inBucket;
+    return lower + (upper - lower) * fraction;
+  }
+  return max();
+}
+
+void Histogram::reset() {
+  for (size_t i = 0; i < bucketCount(); ++i)
+    m_buckets[i].store(0, std::memory_order_relaxed);
+  m_count.store(0, std::memory_order_relaxed);
+  m_sum.store(0.0, std::memory_order_relaxed);
+  m_min.store(std::numeric_limits<double>::infinity(),
+              std::memory_order_relaxed);
+  m_max.store(-std::numeric_limits<double>::infinity(),
+              std::memory_order_relaxed);
+}
+
+Counter &Metrics::counter(const std::string &name) {
+  auto &self = get();
+  std::lock_guard<std::mutex> lock(self.m_mutex);
+  auto &slot = self.m_counters[name];
+  if (!slot)
+    slot = std::make_unique<Counter>();
+  return *slot;
+}
+
+Gauge &Metrics::gauge(const std::string &name) {
+  auto &self = get();
+  std::lock_guard<std::mutex> lock(self.m_mutex);
+  auto &slot = self.m_gaugeMetrics[name];
+  if (!slot)
+    slot = std::make_unique<Gauge>();
+  return *slot;
+}
+
+Histogram &Metrics::histogram(const std::string &name,
+                              const std::vector<double> &upperBounds) {
+  auto &self = get();
+  std::lock_guard<std::mutex> lock(self.m_mutex);
+  auto &slot = self.m_histograms[name];
+  if (!slot)
+    slot = std::make_unique<Histogram>(upperBounds);
+  return *slot;
+}
+
+std::vector<std::pair<std::string, const Histogram *>> Metrics::histograms() {
+  auto &self = get();
+  std::lock_guard<std::mutex> lock(self.m_mutex);
+  std::vector<std::pair<std::string, const Histogram *>> result;
+  result.reserve(self.m_histograms.size());
+  for (const auto &entry : self.m_histograms)
+    result.emplace_back(entry.first, entry.second.get());
+  return result;
+}
+
+void Metrics::sample() {
+  auto &self = get();
+  auto now = std::chrono::steady_clock::now();
+  float elapsed =
+      std::chrono::duration<float>(now - self.m_lastSample).count();
+  if (elapsed < self.m_sampleInterval)
+    return;
+  self.m_lastSample = now;
+
+  std::lock_guard<std::mutex> lock(self.m_mutex);
+
+  size_t rateIndex = 0;
+  for (const auto &entry : self.m_counters) {
+    // Series mirror the sorted map order; a name mismatch means a metric was
+    // registered since the last sample.
+    uint64_t value = entry.second->value();
+    if (rateIndex == self.m_rateSeries.size() ||
+        self.m_rateSeries[rateIndex].name != entry.first) {
+      Series series;
+      series.name = entry.first;
+      self.m_rateSeries.insert(self.m_rateSeries.begin() + rateIndex, series);
+      self.m_lastCounterValues[entry.first] = value;
+    }
+    uint64_t &last = self.m_lastCounterValues[entry.first];
+    self.m_rateSeries[rateIndex].push(static_cast<float>(value - last) /
+                                      elapsed);
+    last = value;
+    ++rateIndex;
+  }
+
+  size_t gaugeIndex = 0;
+  for (const auto &entry : self.m_gaugeMetrics) {
+    if (gaugeIndex == self.m_gaugeSeries.size() ||
+        self.m_gaugeSeries[gaugeIndex].name != entry.first) {
+      Series series;
+      series.name = entry.first;
+      self.m_gaugeSeries.insert(self.m_gaugeSeries.begin() + gaugeIndex,
+                                series);
+    }
+    self.m_gaugeSeries[gaugeIndex].push(
+        static_cast<float>(entry.second->value()));
+    ++gaugeIndex;
+  }
+
+  if (self.m_recording.is_open()) {
+    double timestamp =
+        std::chrono::duration<double>(now - self.m_startTime).count();
+    self.writeRow(timestamp);
+  }
+}
+
+bool Metrics::startRecording(const std::string &filename,
+                             MetricsFormat format) {
+  auto &self = get();
+  stopRecording();
+
+  std::ios::openmode mode = std::ios::out | std::ios::trunc;
+  if (format == MetricsFormat::Binary)
+    mode |= std::ios::binary;
+  self.m_recording.open(filename, mode);
+  if (!self.m_recording.is_open()) {
+    Logger::error("Could not open metrics file '%s'", filename.c_str());
+    return false;
+  }
+
+  self.m_recordingPath = filename;
+  self.m_format = format;
+  self.m_recordedColumns = 0;
+  Logger::info("Recording metrics to '%s'", filename.c_str());
+  return true;
+}
+
+void Metrics::stopRecording() {
+  auto &self = get();
+  if (!self.m_recording.is_open())
+    return;
+  self.m_recording.close();
+  Logger::info("Stopped recording metrics to '%s'",
+               self.m_recordingPath.c_str());
+}
+
+// Columns are: timestamp, one rate per counter, one value per gauge, then
+// count/mean/p50/p99 per histogram. Metrics registered after recording started
+// are picked up by rewriting the header (CSV) or emitting a new schema block
+// (binary), so offline tools should expect the layout to grow.
+void Metrics::writeHeader() {
+  std::vector<std::string> columns;
+  columns.push_back("time_s");
+  for (const auto &series : m_rateSeries)
+    columns.push_back(series.name + ".per_s");
+  for (const auto &series : m_gaugeSeries)
+    columns.push_back(series.name);
+  for (const auto &entry : m_histograms) {
+    columns.push_back(entry.first + ".count");
+    columns.push_back(entry.first + ".mean");
+    columns.push_back(entry.first + ".p50");
+    columns.push_back(entry.first + ".p99");
+  }
+  m_recordedColumns = columns.size();
+
+  if (m_format == MetricsFormat::Csv) {
+    for (size_t i = 0; i < columns.size(); ++i)
+      m_recording << (i ? "," : "") << columns[i];
+    m_recording << "\n";
+    return;
+  }
+
+  // Binary schema block: magic, version, column count, then length-prefixed
+  // column names. Each row that follows is `column count` little-endian
+  // doubles.
+  uint32_t count = static_cast<uint32_t>(columns.size());
+  m_recording.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  m_recording.write(reinterpret_cast<const char *>(&BINARY_VERSION),
+                    sizeof(BINARY_VERSION));
+  m_recording.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  for (const auto &column : columns) {
+    uint32_t length = static_cast<uint32_t>(column.size());
+    m_recording.write(reinterpret_cast<const char *>(&length), sizeof(length));
+    m_recording.write(column.data(), length);
+  }
+}
+
+void Metrics::writeRow(double timestamp) {
+  size_t columns = 1 + m_rateSeries.size() + m_gaugeSeries.size() +
+                   m_histograms.size() * 4;
+  if (columns != m_recordedColumns)
+    writeHeader();
+
+  std::vector<double> row;
+  row.reserve(columns);
+  row.push_back(timestamp);
+  for (const auto &series : m_rateSeries)
+    row.push_back(series.latest);
+  for (const auto &series : m_gaugeSeries)
+    row.push_back(series.latest);
+  for (const auto &entry : m_histograms) {
+    const Histogram &h = *entry.second;
+    row.push_back(static_cast<double>(h.count()));
+    row.push_back(h.mean());
+    row.push_back(h.quantile(0.5));
+    row.push_back(h.quantile(0.99));
+  }
+
+  if (m_format == MetricsFormat::Csv) {
+    for (size_t i = 0; i < row.size(); ++i)
+      m_recording << (i ? "," : "") << row[i];
+    m_recording << "\n";
+  } else {
+    m_recording.write(reinterpret_cast<const char *>(row.data()),
+                      row.size() * sizeof(double));
+  }
+  m_recording.flush();
+}
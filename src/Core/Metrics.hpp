@@ -0,0 +1,212 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Monotonic event counter. Updates are a single relaxed atomic add, so it is
+// safe to bump from any thread without coordination.
+class Counter {
+public:
+  void increment(uint64_t n = 1) {
+    m_value.fetch_add(n, std::memory_order_relaxed);
+  }
+  uint64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint64_t> m_value{0};
+};
+
+// Last-written value of a sampled quantity (epsilon, replay size, ...).
+class Gauge {
+public:
+  void set(double value) { m_value.store(value, std::memory_order_relaxed); }
+  double value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<double> m_value{0.0};
+};
+
+// Fixed-bucket histogram. Bucket bounds are immutable after construction and
+// every observation is a handful of relaxed atomic operations (no locks).
+class Histogram {
+public:
+  explicit Histogram(std::vector<double> upperBounds);
+
+  // Buckets growing geometrically from `start`, e.g. latency in microseconds.
+  static std::vector<double> exponentialBounds(double start, double factor,
+                                               int count);
+  static std::vector<double> linearBounds(double start, double width,
+                                          int count);
+
+  void observe(double value);
+
+  uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+  double sum() const { return m_sum.load(std::memory_order_relaxed); }
+  double mean() const;
+  double min() const { return m_min.load(std::memory_order_relaxed); }
+  double max() const { return m_max.load(std::memory_order_relaxed); }
+
+  // Approximate quantile (q in [0, 1]) interpolated inside the bucket.
+  double quantile(double q) const;
+
+  size_t bucketCount() const { return m_bounds.size() + 1; }
+  uint64_t bucketValue(size_t index) const {
+    return m_buckets[index].load(std::memory_order_relaxed);
+  }
+  const std::vector<double> &bounds() const { return m_bounds; }
+
+  void reset();
+
+private:
+  std::vector<double> m_bounds;
+  std::unique_ptr<std::atomic<uint64_t>[]> m_buckets;
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<double> m_sum{0.0};
+  std::atomic<double> m_min;
+  std::atomic<double> m_max;
+};
+
+// Records the elapsed wall time of a scope into a histogram, in microseconds.
+class ScopedTimer {
+public:
+  explicit ScopedTimer(Histogram &histogram)
+      : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+  ~ScopedTimer() {
+    auto elapsed = std::chrono::steady_clock::now() - m_start;
+    m_histogram.observe(
+        std::chrono::duration<double, std::micro>(elapsed).count());
+  }
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+  Histogram &m_histogram;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+enum class MetricsFormat { Csv, Binary };
+
+// Process-wide metrics registry.
+//
+// Registration takes a mutex and returns a reference that stays valid for the
+// lifetime of the program, so hot paths should look a metric up once and keep
+// the reference. Updating a metric never locks.
+//
+// `sample()` is meant to be called once per frame from the main loop: once per
+// sample interval it turns counters into per-second rates, appends a point to
+// each series' history (for the dashboard) and streams a row to the recording
+// file if one is open.
+class Metrics {
+public:
+  static constexpr size_t HISTORY_SIZE = 120;
+
+  struct Series {
+    std::string name;
+    std::vector<float> history = std::vector<float>(HISTORY_SIZE, 0.0f);
+    size_t offset = 0;
+    float latest = 0.0f;
+
+    void push(float value) {
+      latest = value;
+      history[offset] = value;
+      offset = (offset + 1) % history.size();
+    }
+  };
+
+  static Counter &counter(const std::string &name);
+  static Gauge &gauge(const std::string &name);
+  static Histogram &histogram(const std::string &name,
+                              const std::vector<double> &upperBounds =
+                                  Histogram::exponentialBounds(1.0, 2.0, 20));
+
+  static void sample();
+  static void setSampleInterval(float seconds) {
+    get().m_sampleInterval = seconds;
+  }
+  static float sampleInterval() { return get().m_sampleInterval; }
+
+  static bool startRecording(const std::string &filename,
+                             MetricsFormat format = MetricsFormat::Csv);
+  static void stopRecording();
+  static bool isRecording() { return get().m_recording.is_open(); }
+  static const std::string &recordingPath() { return get().m_recordingPath; }
+
+  // Read-only views for the dashboard. Must be called from the thread that
+  // calls sample().
+  static const std::vector<Series> &rateSeries() {
+    return get().m_rateSeries;
+  }
+  static const std::vector<Series> &gaugeSeries() {
+    return get().m_gaugeSeries;
+  }
+  static std::vector<std::pair<std::string, const Histogram *>> histograms();
+
+private:
+  static Metrics &get() {
+    static Metrics instance;
+    return instance;
+  }
+
+  Metrics() = default;
+  ~Metrics() {
+    if (m_recording.is_open())
+      m_recording.close();
+  }
+
+  Metrics(const Metrics &) = delete;
+  Metrics &operator=(const Metrics &) = delete;
+
+  void writeHeader();
+  void writeRow(double timestamp);
+
+  std::mutex m_mutex;
+  std::map<std::string, std::unique_ptr<Counter>> m_counters;
+  std::map<std::string, std::unique_ptr<Gauge>> m_gaugeMetrics;
+  std::map<std::string, std::unique_ptr<Histogram>> m_histograms;
+
+  // Sampling state, owned by the thread that calls sample().
+  std::vector<Series> m_rateSeries;
+  std::vector<Series> m_gaugeSeries;
+  std::map<std::string, uint64_t> m_lastCounterValues;
+  std::chrono::steady_clock::time_point m_startTime =
+      std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point m_lastSample = m_startTime;
+  float m_sampleInterval = 1.0f;
+
+  std::ofstream m_recording;
+  std::string m_recordingPath;
+  MetricsFormat m_format = MetricsFormat::Csv;
+  size_t m_recordedColumns = 0;
+};
+
+// Names shared between the producers (agent, trainer) and the dashboard.
+namespace MetricNames {
+inline constexpr const char *EnvSteps = "env.steps";
+inline constexpr const char *GradientUpdates = "train.updates";
+inline constexpr const char *ReplaySize = "replay.size";
+inline constexpr const char *Epsilon = "agent.epsilon";
+inline constexpr const char *EpisodeReward = "episode.reward";
+inline constexpr const char *SampleLatency = "replay.sample_us";
+inline constexpr const char *ForwardTime = "nn.forward_us";
+inline constexpr const char *BackwardTime = "nn.backward_us";
+inline constexpr const char *TDError = "train.td_error";
+inline constexpr const char *EpisodeRewards = "episode.rewards";
+inline constexpr const char *CheckpointSnapshotTime = "checkpoint.snapshot_us";
+inline constexpr const char *CheckpointWriteTime = "checkpoint.write_us";
+inline constexpr const char *CombatHits = "combat.hits";
+inline constexpr const char *CombatBlocks = "combat.blocks";
+inline constexpr const char *CombatWhiffs = "combat.whiffs";
+inline constexpr const char *CombatKOs = "combat.kos";
+inline constexpr const char *CombatRounds = "combat.rounds";
+inline constexpr const char *FrameArenaBytes = "arena.frame_bytes";
+inline constexpr const char *FrameArenaAllocations = "arena.allocs";
+inline constexpr const char *FrameArenaSpills = "arena.spills";
+} // namespace MetricNames
@@ -1,6 +1,8 @@
 #pragma once
 #include "FightEnums.hpp"
 #include <SDL.h>
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -19,8 +21,115 @@ struct Frame {
   FramePhase phase;
 };
 
+constexpr int HITBOX_TYPE_COUNT = static_cast<int>(HitboxType::Grab) + 1;
+
+// Hitboxes of every frame of an animation, resolved once at load time so a
+// query is a lookup instead of a walk over Frame::hitboxes. All rects are
+// relative to the frame's top-left corner and stored per component.
+//
+// For each frame, type and facing there is the union of the enabled boxes
+// of that type (or the centred half-size fallback when there are none).
+// The individual Hit boxes of frame f are [hitBegin[f], hitBegin[f + 1]),
+// with their x for both facings.
+struct HitboxTable {
+  std::vector<int> boundsX, boundsY, boundsW, boundsH;
+  std::vector<uint8_t> hasBounds;
+  std::vector<int> hitBegin;
+  std::vector<int> hitX, hitFlippedX, hitY, hitW, hitH;
+
+  static size_t slot(size_t frame, HitboxType type, bool flipped) {
+    return (frame * HITBOX_TYPE_COUNT + static_cast<size_t>(type)) * 2 +
+           (flipped ? 1 : 0);
+  }
+
+  SDL_Rect bounds(size_t frame, HitboxType type, bool flipped) const {
+    size_t i = slot(frame, type, flipped);
+    return SDL_Rect{boundsX[i], boundsY[i], boundsW[i], boundsH[i]};
+  }
+  bool has(size_t frame, HitboxType type) const {
+    return hasBounds[slot(frame, type, false)] != 0;
+  }
+  SDL_Rect hitBox(size_t index, bool flipped) const {
+    return SDL_Rect{flipped ? hitFlippedX[index] : hitX[index], hitY[index],
+                    hitW[index], hitH[index]};
+  }
+
+  void build(const std::vector<Frame> &frames) {
+    const size_t slots = frames.size() * HITBOX_TYPE_COUNT * 2;
+    for (std::vector<int> *column : {&boundsX, &boundsY, &boundsW, &boundsH})
+      column->assign(slots, 0);
+    hasBounds.assign(slots, 0);
+    hitBegin.assign(1, 0);
+    for (std::vector<int> *column : {&hitX, &hitFlippedX, &hitY, &hitW, &hitH})
+      column->clear();
+
+    for (size_t f = 0; f < frames.size(); ++f) {
+      const Frame &frame = frames[f];
+      const int frameW = frame.frameRect.w;
+      const int frameH = frame.frameRect.h;
+      for (int t = 0; t < HITBOX_TYPE_COUNT; ++t) {
+        const HitboxType type = static_cast<HitboxType>(t);
+        int x1 = 0;
+        int y1 = 0;
+        int x2 = 0;
+        int y2 = 0;
+        bool found = false;
+        for (const Hitbox &hb : frame.hitboxes) {
+          if (!hb.enabled || hb.type != type)
+            continue;
+          if (!found) {
+            x1 = hb.x;
+            y1 = hb.y;
+            x2 = hb.x + hb.w;
+            y2 = hb.y + hb.h;
+            found = true;
+          } else {
+            x1 = std::min(x1, hb.x);
+            y1 = std::min(y1, hb.y);
+            x2 = std::max(x2, hb.x + hb.w);
+            y2 = std::max(y2, hb.y + hb.h);
+          }
+        }
+        if (!found) {
+          x1 = frameW / 4;
+          y1 = frameH / 4;
+          x2 = x1 + frameW / 2;
+          y2 = y1 + frameH / 2;
+        }
+        for (int flipped = 0; flipped < 2; ++flipped) {
+          size_t i = slot(f, type, flipped != 0);
+          // Mirroring [x1, x2) across the frame gives [w - x2, w - x1). The
+          // fallback box is centred and stays put.
+          boundsX[i] = flipped && found ? frameW - x2 : x1;
+          boundsY[i] = y1;
+          boundsW[i] = x2 - x1;
+          boundsH[i] = y2 - y1;
+          hasBounds[i] = found;
+        }
+      }
+
+      for (const Hitbox &hb : frame.hitboxes) {
+        if (!hb.enabled || hb.type != HitboxType::Hit)
+          continue;
+        hitX.push_back(hb.x);
+        hitFlippedX.push_back(frameW - (hb.x + hb.w));
+        hitY.push_back(hb.y);
+        hitW.push_back(hb.w);
+        hitH.push_back(hb.h);
+      }
+      hitBegin.push_back(static_cast<int>(hitX.size()));
+    }
+  }
+};
+
 struct Animation {
   std::string name;
   std::vector<Frame> frames;
   bool loop;
+  // Index of the animation within its Animator; -1 until added to one.
+  int id = -1;
+  // Derived from `frames`; rebuild after editing them.
+  HitboxTable hitboxes;
+
+  void buildHitboxTable() { hitboxes.build(frames); }
 };
@@ -36,3 +36,39 @@ struct Vector2f {
     return (len > 0.f) ? Vector2f(x / len, y / len) : Vector2f(0.f, 0.f);
   }
 };
+
+// A vector whose components live in two separate float arrays (see
+// FighterPool). Reads convert to Vector2f; assignment writes through.
+struct Vector2fRef {
+  float &x;
+  float &y;
+
+  Vector2fRef(float &x, float &y) : x(x), y(y) {}
+  Vector2fRef(const Vector2fRef &) = default;
+
+  Vector2fRef &operator=(const Vector2f &v) {
+    x = v.x;
+    y = v.y;
+    return *this;
+  }
+  Vector2fRef &operator=(const Vector2fRef &v) {
+    return *this = static_cast<Vector2f>(v);
+  }
+  operator Vector2f() const { return Vector2f(x, y); }
+
+  Vector2f operator+(const Vector2f &other) const {
+    return Vector2f(x + other.x, y + other.y);
+  }
+  Vector2f operator-(const Vector2f &other) const {
+    return Vector2f(x - other.x, y - other.y);
+  }
+  Vector2f operator*(float scalar) const {
+    return Vector2f(x * scalar, y * scalar);
+  }
+  Vector2fRef &operator+=(const Vector2f &other) {
+    x += other.x;
+    y += other.y;
+    return *this;
+  }
+  float length() const { return std::sqrt(x * x + y * y); }
+};
@@ -0,0 +1,94 @@
+#include "BroadPhase.hpp"
+#include "Game/CollisionSystem.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+template <typename Entry> bool accepts(const Entry &a, const Entry &b) {
+  return a.owner != b.owner && ((a.mask & b.layer) || (b.mask & a.layer));
+}
+} // namespace
+
+int BroadPhase::add(const SDL_Rect &box, int owner, uint32_t layer,
+                    uint32_t mask) {
+  // Empty boxes never intersect (SDL_HasIntersection agrees), so they are
+  // not worth sweeping.
+  if (box.w <= 0 || box.h <= 0)
+    return -1;
+  m_boxes.push_back({box, owner, layer, mask});
+  return static_cast<int>(m_boxes.size()) - 1;
+}
+
+void BroadPhase::clear() { m_boxes.clear(); }
+
+const std::vector<BroadPhase::Pair> &BroadPhase::findPairs() {
+  m_pairs.clear();
+  const int count = static_cast<int>(m_boxes.size());
+  if (static_cast<int>(m_order.size()) != count) {
+    m_order.resize(count);
+    std::iota(m_order.begin(), m_order.end(), 0);
+  }
+
+  // Insertion sort: near-linear on last tick's order, which is almost
+  // always still sorted.
+  for (int i = 1; i < count; ++i) {
+    const int index = m_order[i];
+    const int left = m_boxes[index].rect.x;
+    int j = i;
+    for (; j > 0 && m_boxes[m_order[j - 1]].rect.x > left; --j)
+      m_order[j] = m_order[j - 1];
+    m_order[j] = index;
+  }
+
+  // The boxes after i that start left of its right edge form its active
+  // interval. On a spread-out stage it holds a box or two and is swept
+  // directly; a crowd (known from a single look MIN_BATCH boxes ahead) is
+  // tested with one intersectBatch call, which needs the boxes gathered
+  // into columns in sweep order first.
+  bool gathered = false;
+  for (int i = 0; i < count; ++i) {
+    const Entry &first = m_boxes[m_order[i]];
+    const SDL_Rect &box = first.rect;
+    const int right = box.x + box.w;
+    const int begin = i + 1;
+
+    if (begin + MIN_BATCH > count ||
+        m_boxes[m_order[begin + MIN_BATCH - 1]].rect.x >= right) {
+      for (int j = begin; j < count; ++j) {
+        const Entry &second = m_boxes[m_order[j]];
+        if (second.rect.x >= right)
+          break;
+        // add() keeps empty boxes out, so X overlaps here.
+        if (accepts(first, second) && box.y < second.rect.y + second.rect.h &&
+            second.rect.y < box.y + box.h)
+          addPair(i, j);
+      }
+      continue;
+    }
+
+    if (!gathered) {
+      m_sorted.resize(count);
+      for (int k = 0; k < count; ++k)
+        m_sorted.set(k, m_boxes[m_order[k]].rect);
+      m_mask.resize(CollisionSystem::maskWords(count));
+      gathered = true;
+    }
+    int end = begin + MIN_BATCH;
+    while (end < count && m_sorted.x[end] < right)
+      ++end;
+    if (CollisionSystem::intersectBatch(
+            box, &m_sorted.x[begin], &m_sorted.y[begin], &m_sorted.w[begin],
+            &m_sorted.h[begin], end - begin, m_mask.data()) == 0)
+      continue;
+    for (size_t word = 0; word < CollisionSystem::maskWords(end - begin);
+         ++word) {
+      for (uint64_t bits = m_mask[word]; bits != 0; bits &= bits - 1) {
+        const int j =
+            begin + static_cast<int>(word * 64) + __builtin_ctzll(bits);
+        if (accepts(first, m_boxes[m_order[j]]))
+          addPair(i, j);
+      }
+    }
+  }
+  return m_pairs;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Game/CollisionSystem.hpp"
+#include <SDL.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Sort-and-sweep broad phase over axis-aligned boxes.
+//
+// Boxes are re-added every tick (clear() then add()), each tagged with the
+// fighter or projectile that owns it and a layer bit. findPairs() sorts the
+// boxes by left edge and sweeps along X, which on a side-scrolling stage
+// leaves few boxes in the active interval; crowded intervals are tested
+// against their box with one CollisionSystem::intersectBatch call. The
+// sort order is kept between ticks and insertion-sorted, so a stage whose
+// boxes barely move costs close to linear time.
+//
+// Candidates are boxes that overlap, belong to different owners and whose
+// layers accept each other; the narrow phase decides what the contact means.
+class BroadPhase {
+public:
+  struct Pair {
+    int a; // Box indices, as returned by add(); a < b.
+    int b;
+  };
+
+  // `mask` is the set of layers this box wants to be paired with. A pair is
+  // reported when either box's mask accepts the other's layer.
+  int add(const SDL_Rect &box, int owner, uint32_t layer, uint32_t mask);
+  void clear();
+
+  const std::vector<Pair> &findPairs();
+
+  size_t size() const { return m_boxes.size(); }
+  const SDL_Rect &box(int index) const { return m_boxes[index].rect; }
+  int owner(int index) const { return m_boxes[index].owner; }
+  uint32_t layer(int index) const { return m_boxes[index].layer; }
+
+private:
+  struct Entry {
+    SDL_Rect rect;
+    int owner;
+    uint32_t layer;
+    uint32_t mask;
+  };
+
+  std::vector<Entry> m_boxes;
+  // Box indices by ascending left edge, carried over between ticks.
+  std::vector<int> m_order;
+  // m_boxes in sweep order as columns, for CollisionSystem::intersectBatch.
+  BoxList m_sorted;
+  std::vector<uint64_t> m_mask;
+  std::vector<Pair> m_pairs;
+
+  // Shorter active intervals are cheaper to test one box at a time.
+  static constexpr int MIN_BATCH = 8;
+
+  // Records the boxes at sweep positions `first` and `second`.
+  void addPair(int first, int second) {
+    m_pairs.push_back({std::min(m_order[first], m_order[second]),
+                       std::max(m_order[first], m_order[second])});
+  }
+};
+
+// Layer bits used by the game's passes.
+enum CollisionLayer : uint32_t {
+  BodyLayer = 1u << 0,   // Collision box: pushing and getting hit
+  GuardLayer = 1u << 1,  // Block box
+  AttackLayer = 1u << 2, // Active hit boxes
+};
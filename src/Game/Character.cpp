@@ -1,6 +1,4 @@
 #include "Character.hpp"
-#include "Core/DebugEvents.hpp"
-#include "Core/DebugGlobals.hpp"
 #include "Core/Input.hpp"
 #include "Core/Logger.hpp"
 #include "Data/Animation.hpp"
@@ -8,58 +6,59 @@
 #include <SDL.h>
 #include <algorithm>
 
-Character::Character(Animator *anim, Config &config)
-    : animator(anim), health(100), maxHealth(100), onGround(false),
-      isMoving(false), groundFrames(0), inputDirection(0), stamina(500.0f),
-      maxStamina(500.0f), m_config(config) {}
-
-SDL_Rect Character::getHitboxRect(HitboxType type) const {
-  const auto &hitboxes = animator->getCurrentHitboxes();
-  SDL_Rect collisionRect;
-  bool foundCollisionBox = false;
-
-  SDL_Rect frameRect = animator->getCurrentFrameRect();
-
-  for (const auto &hb : hitboxes) {
-    if (!hb.enabled || hb.type != type)
-      continue;
-
-    SDL_Rect hbRect;
-    if (animator->getFlip()) {
-
-      hbRect.x = frameRect.w - (hb.x + hb.w);
-    } else {
-      hbRect.x = hb.x;
-    }
-    hbRect.y = hb.y;
-    hbRect.w = hb.w;
-    hbRect.h = hb.h;
-
-    if (!foundCollisionBox) {
-      collisionRect = hbRect;
-      foundCollisionBox = true;
-    } else {
-
-      int x1 = std::min(collisionRect.x, hbRect.x);
-      int y1 = std::min(collisionRect.y, hbRect.y);
-      int x2 = std::max(collisionRect.x + collisionRect.w, hbRect.x + hbRect.w);
-      int y2 = std::max(collisionRect.y + collisionRect.h, hbRect.y + hbRect.h);
-      collisionRect.x = x1;
-      collisionRect.y = y1;
-      collisionRect.w = x2 - x1;
-      collisionRect.h = y2 - y1;
-    }
-  }
+Character::Character(Animator *anim, Config &config, FighterPool &pool)
+    : Character(anim, config, pool, pool.add()) {}
+
+Character::Character(Animator *anim, Config &config, FighterPool &pool,
+                     int index)
+    : mover(pool, index), animator(anim), health(pool.health[index]),
+      maxHealth(pool.maxHealth[index]), onGround(pool.onGround[index]),
+      isMoving(pool.isMoving[index]),
+      groundFrames(pool.groundFrames[index]), inputDirection(0),
+      stamina(pool.stamina[index]), maxStamina(pool.maxStamina[index]),
+      m_poolIndex(index), m_config(config) {
+  animator->attach(pool.playback[index]);
+}
 
-  if (!foundCollisionBox) {
+Character::Snapshot Character::snapshot() const {
+  Snapshot snapshot;
+  snapshot.position = mover.position;
+  snapshot.velocity = mover.velocity;
+  snapshot.acceleration = mover.acceleration;
+  snapshot.health = health;
+  snapshot.stamina = stamina;
+  snapshot.onGround = onGround;
+  snapshot.isMoving = isMoving;
+  snapshot.groundFrames = groundFrames;
+  snapshot.inputDirection = inputDirection;
+  snapshot.comboCount = comboCount;
+  snapshot.state = state;
+  snapshot.animationTimer = m_currentAnimationTimer;
+  snapshot.animation = animator->snapshot();
+  return snapshot;
+}
 
-    collisionRect = {frameRect.w / 4, frameRect.h / 4, frameRect.w / 2,
-                     frameRect.h / 2};
-  }
+void Character::restore(const Snapshot &snapshot) {
+  mover.position = snapshot.position;
+  mover.velocity = snapshot.velocity;
+  mover.acceleration = snapshot.acceleration;
+  health = snapshot.health;
+  stamina = snapshot.stamina;
+  onGround = snapshot.onGround;
+  isMoving = snapshot.isMoving;
+  groundFrames = snapshot.groundFrames;
+  inputDirection = snapshot.inputDirection;
+  comboCount = snapshot.comboCount;
+  state = snapshot.state;
+  m_currentAnimationTimer = snapshot.animationTimer;
+  animator->restore(snapshot.animation);
+}
 
-  collisionRect.x += static_cast<int>(mover.position.x);
-  collisionRect.y += static_cast<int>(mover.position.y);
-  return collisionRect;
+SDL_Rect Character::getHitboxRect(HitboxType type) const {
+  SDL_Rect rect = animator->getCurrentHitboxBounds(type);
+  rect.x += static_cast<int>(mover.position.x);
+  rect.y += static_cast<int>(mover.position.y);
+  return rect;
 }
 
 void Character::handleInput() {
@@ -111,7 +110,7 @@ void Character::attack() {
   stamina -= attackCost;
 
   FramePhase phase = animator->getCurrentFramePhase();
-  auto currentAnimationKey = animator->getCurrentAnimationKey();
+  const std::string &currentAnimationKey = animator->getCurrentAnimationKey();
 
   if (phase == FramePhase::Recovery) {
     if (currentAnimationKey == "Attack") {
@@ -173,12 +172,7 @@ void Character::applyDamage(int damage, bool survive) {
   health -= damage * (isBlocking ? 0.1f : 1.f);
   if (health < 0)
     health = survive ? 1 : 0;
-  Logger::debug("Damage applied: " + std::to_string(damage) +
-                ". Health now: " + std::to_string(health));
-
-  if (g_showFloatingDamage) {
-    addDamageEvent(mover.position, damage);
-  }
+  Logger::debug("Damage applied: %d. Health now: %d", damage, health);
 
   if (comboCount >= 2 && animator->getCurrentAnimationKey() != "Knocked") {
     animator->play("Knocked");
@@ -189,53 +183,22 @@ void Character::applyDamage(int damage, bool survive) {
   }
 }
 
-void Character::update(float deltaTime) {
-  std::string currentAnim = animator->getCurrentAnimationKey();
+void Character::updateAnimationTimeout(float deltaTime) {
+  const std::string &currentAnim = animator->getCurrentAnimationKey();
   if (currentAnim != "Idle" && currentAnim != "Walk") {
     m_currentAnimationTimer += deltaTime;
     if (m_currentAnimationTimer > MAX_ANIMATION_DURATION) {
-      Logger::debug("Animation '" + currentAnim +
-                    "' stuck for too long, reverting to Idle");
+      Logger::debug("Animation '%s' stuck for too long, reverting to Idle",
+                    currentAnim.c_str());
       animator->play("Idle");
       m_currentAnimationTimer = 0.0f;
     }
   } else {
     m_currentAnimationTimer = 0.0f;
   }
+}
 
-  SDL_Rect collRect = getHitboxRect();
-  if (collRect.h == 0) {
-    collRect = animator->getCurrentFrameRect();
-  }
-
-  if (!onGround) {
-    mover.applyForce(Vector2f(0, m_config.gravity));
-  }
-
-  collRect = getHitboxRect();
-  if (collRect.h == 0) {
-    collRect = animator->getCurrentFrameRect();
-  }
-
-  float charBottom = mover.position.y + collRect.h;
-  float groundY = m_config.groundLevel;
-
-  if (charBottom >= groundY) {
-    mover.position.y = groundY - collRect.h;
-    mover.velocity.y = 0;
-    onGround = true;
-    groundFrames++;
-  } else if (charBottom < groundY - m_config.groundThreshold) {
-    onGround = false;
-    groundFrames = 0;
-  }
-
-  const float staminaRecoveryRate = 50.0f;
-  stamina = std::min(maxStamina, stamina + staminaRecoveryRate * deltaTime);
-
-  mover.update(deltaTime);
-  animator->update(deltaTime);
-
+void Character::updateAnimationState() {
   FramePhase currentPhase = animator->getCurrentFramePhase();
   if (currentPhase == FramePhase::Active ||
       currentPhase == FramePhase::Startup) {
@@ -357,8 +320,6 @@ void Character::updateJumpAnimation() {
     const float FALL_SLOW = 200.0f;
     const float FALL_FAST = 500.0f;
 
-    std::string currentAnim = animator->getCurrentAnimationKey();
-
     if (vy < RISE_FAST) {
 
       animator->play("Jump");
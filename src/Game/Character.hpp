@@ -2,40 +2,69 @@
 #include "CharacterState.hpp"
 #include "Core/Config.hpp"
 #include "Data/Animation.hpp"
+#include "Game/FighterPool.hpp"
 #include "Game/Mover.hpp"
 #include "Rendering/Animator.hpp"
 #include "Rendering/Camera.hpp"
 #include <SDL.h>
 
+// Gameplay handle of one fighter. The simulated state (motion, health,
+// stamina, ground flags and animation playback) lives in a FighterPool slot
+// and the members below are references into it.
 class Character {
 public:
   Mover mover;
   Animator *animator;
-  int health;
-  int maxHealth;
-  bool onGround;
-  bool isMoving;
-  int groundFrames;
-  bool lastAttackLanded;
-  bool lastBlockEffective;
+  int &health;
+  int &maxHealth;
+  bool &onGround;
+  bool &isMoving;
+  int &groundFrames;
 
   // TODO: Change it to an enum
   // Last horizontal input: -1 for left, +1 for right, 0 for none.
   int inputDirection;
   int comboCount = 0;
-  float stamina;
-  float maxStamina;
+  float &stamina;
+  float &maxStamina;
 
   // State
-  CharacterState state;
-
-  Character(Animator *anim, Config &config);
+  CharacterState state = CharacterState::Idle;
+
+  // Claims a slot in `pool` and attaches the animator's playback to it.
+  Character(Animator *anim, Config &config, FighterPool &pool);
+
+  int poolIndex() const { return m_poolIndex; }
+
+  // Everything a new round resets: the slot's motion, health, stamina and
+  // ground flags, the animation, and the per-fighter logic state. Tuning
+  // (mass, friction, maxima) is left alone.
+  struct Snapshot {
+    Vector2f position;
+    Vector2f velocity;
+    Vector2f acceleration;
+    int health = 0;
+    float stamina = 0.0f;
+    bool onGround = false;
+    bool isMoving = false;
+    int groundFrames = 0;
+    int inputDirection = 0;
+    int comboCount = 0;
+    CharacterState state = CharacterState::Idle;
+    float animationTimer = 0.0f;
+    Animator::Snapshot animation;
+  };
+  Snapshot snapshot() const;
+  void restore(const Snapshot &snapshot);
 
   SDL_Rect getHitboxRect(HitboxType type = HitboxType::Collision) const;
 
   void handleInput();
 
-  void update(float deltaTime);
+  // Per-fighter logic around FighterPool::step(): reverts animations that
+  // are stuck before it, and picks the next animation after it.
+  void updateAnimationTimeout(float deltaTime);
+  void updateAnimationState();
 
   void render(SDL_Renderer *renderer, float cameraScale = 1.0f);
   void renderWithCamera(SDL_Renderer *renderer, const Camera &camera,
@@ -58,6 +87,9 @@ public:
   void updateJumpAnimation();
 
 private:
+  Character(Animator *anim, Config &config, FighterPool &pool, int index);
+
+  int m_poolIndex;
   Config &m_config;
   const float MAX_ANIMATION_DURATION = 2.0f;
   float m_currentAnimationTimer = 0.0f;
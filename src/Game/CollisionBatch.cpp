@@ -0,0 +1,197 @@
+// CollisionSystem::intersectBatch and its per-ISA kernels. Kept apart from
+// CollisionSystem.cpp so tools such as the broad-phase benchmark can link
+// the kernels without the rest of the game.
+#include "CollisionSystem.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BOX_X86 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define BOX_NEON 1
+#endif
+
+namespace {
+// A box overlaps the query when x < qRight && qX < x + w (and the same
+// vertically), with both boxes non-empty. The query's emptiness is
+// checked once by the caller.
+struct Query {
+  int32_t x, y, right, bottom;
+};
+
+using BatchKernel = void (*)(const Query &, const int32_t *, const int32_t *,
+                             const int32_t *, const int32_t *, size_t,
+                             uint64_t *);
+
+inline bool overlaps(const Query &q, int32_t x, int32_t y, int32_t w,
+                     int32_t h) {
+  return w > 0 && h > 0 && x < q.right && q.x < x + w && y < q.bottom &&
+         q.y < y + h;
+}
+
+inline void setBit(uint64_t *mask, size_t i) {
+  mask[i / 64] |= uint64_t{1} << (i % 64);
+}
+
+// Boxes from `begin` on, one at a time: the whole batch without SIMD, or
+// the lanes left over after the vector loop.
+inline void batchTail(const Query &q, const int32_t *x, const int32_t *y,
+                      const int32_t *w, const int32_t *h, size_t begin,
+                      size_t count, uint64_t *mask) {
+  for (size_t i = begin; i < count; ++i)
+    if (overlaps(q, x[i], y[i], w[i], h[i]))
+      setBit(mask, i);
+}
+
+#if defined(BOX_X86)
+// SSE2 is part of x86-64, so this needs no dispatch.
+void batchSse2(const Query &q, const int32_t *x, const int32_t *y,
+               const int32_t *w, const int32_t *h, size_t count,
+               uint64_t *mask) {
+  const __m128i qx = _mm_set1_epi32(q.x);
+  const __m128i qy = _mm_set1_epi32(q.y);
+  const __m128i qRight = _mm_set1_epi32(q.right);
+  const __m128i qBottom = _mm_set1_epi32(q.bottom);
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i *>(x + i));
+    __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y + i));
+    __m128i vw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w + i));
+    __m128i vh = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i));
+    __m128i hit = _mm_and_si128(_mm_cmpgt_epi32(vw, zero),
+                                _mm_cmpgt_epi32(vh, zero));
+    hit = _mm_and_si128(hit, _mm_cmplt_epi32(vx, qRight));
+    hit = _mm_and_si128(hit, _mm_cmplt_epi32(qx, _mm_add_epi32(vx, vw)));
+    hit = _mm_and_si128(hit, _mm_cmplt_epi32(vy, qBottom));
+    hit = _mm_and_si128(hit, _mm_cmplt_epi32(qy, _mm_add_epi32(vy, vh)));
+    uint64_t bits = _mm_movemask_ps(_mm_castsi128_ps(hit));
+    mask[i / 64] |= bits << (i % 64);
+  }
+  batchTail(q, x, y, w, h, i, count, mask);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BOX_AVX2 1
+__attribute__((target("avx2"), always_inline)) inline __m256i
+load8(const int32_t *p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+__attribute__((target("avx2"))) void
+batchAvx2(const Query &q, const int32_t *x, const int32_t *y,
+          const int32_t *w, const int32_t *h, size_t count, uint64_t *mask) {
+  const __m256i qx = _mm256_set1_epi32(q.x);
+  const __m256i qy = _mm256_set1_epi32(q.y);
+  const __m256i qRight = _mm256_set1_epi32(q.right);
+  const __m256i qBottom = _mm256_set1_epi32(q.bottom);
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i vx = load8(x + i);
+    __m256i vy = load8(y + i);
+    __m256i vw = load8(w + i);
+    __m256i vh = load8(h + i);
+    __m256i hit = _mm256_and_si256(_mm256_cmpgt_epi32(vw, zero),
+                                   _mm256_cmpgt_epi32(vh, zero));
+    hit = _mm256_and_si256(hit, _mm256_cmpgt_epi32(qRight, vx));
+    hit = _mm256_and_si256(
+        hit, _mm256_cmpgt_epi32(_mm256_add_epi32(vx, vw), qx));
+    hit = _mm256_and_si256(hit, _mm256_cmpgt_epi32(qBottom, vy));
+    hit = _mm256_and_si256(
+        hit, _mm256_cmpgt_epi32(_mm256_add_epi32(vy, vh), qy));
+    uint64_t bits = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+    mask[i / 64] |= bits << (i % 64);
+  }
+  batchTail(q, x, y, w, h, i, count, mask);
+}
+#endif
+#endif
+
+#if !defined(BOX_X86) && !defined(BOX_NEON)
+void batchScalar(const Query &q, const int32_t *x, const int32_t *y,
+                 const int32_t *w, const int32_t *h, size_t count,
+                 uint64_t *mask) {
+  batchTail(q, x, y, w, h, 0, count, mask);
+}
+#endif
+
+#if defined(BOX_NEON)
+void batchNeon(const Query &q, const int32_t *x, const int32_t *y,
+               const int32_t *w, const int32_t *h, size_t count,
+               uint64_t *mask) {
+  const int32x4_t qx = vdupq_n_s32(q.x);
+  const int32x4_t qy = vdupq_n_s32(q.y);
+  const int32x4_t qRight = vdupq_n_s32(q.right);
+  const int32x4_t qBottom = vdupq_n_s32(q.bottom);
+  const int32x4_t zero = vdupq_n_s32(0);
+  const uint32_t laneBits[4] = {1, 2, 4, 8};
+  const uint32x4_t lanes = vld1q_u32(laneBits);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    int32x4_t vx = vld1q_s32(x + i);
+    int32x4_t vy = vld1q_s32(y + i);
+    int32x4_t vw = vld1q_s32(w + i);
+    int32x4_t vh = vld1q_s32(h + i);
+    uint32x4_t hit = vandq_u32(vcgtq_s32(vw, zero), vcgtq_s32(vh, zero));
+    hit = vandq_u32(hit, vcltq_s32(vx, qRight));
+    hit = vandq_u32(hit, vcltq_s32(qx, vaddq_s32(vx, vw)));
+    hit = vandq_u32(hit, vcltq_s32(vy, qBottom));
+    hit = vandq_u32(hit, vcltq_s32(qy, vaddq_s32(vy, vh)));
+    uint64_t bits = vaddvq_u32(vandq_u32(hit, lanes));
+    mask[i / 64] |= bits << (i % 64);
+  }
+  batchTail(q, x, y, w, h, i, count, mask);
+}
+#endif
+
+BatchKernel selectKernel() {
+#if defined(BOX_AVX2)
+  if (__builtin_cpu_supports("avx2"))
+    return batchAvx2;
+#endif
+#if defined(BOX_X86)
+  return batchSse2;
+#elif defined(BOX_NEON)
+  return batchNeon;
+#else
+  return batchScalar;
+#endif
+}
+
+BatchKernel kernel() {
+  static const BatchKernel choice = selectKernel();
+  return choice;
+}
+
+size_t countBits(const uint64_t *mask, size_t words) {
+  size_t hits = 0;
+  for (size_t i = 0; i < words; ++i)
+    hits += static_cast<size_t>(__builtin_popcountll(mask[i]));
+  return hits;
+}
+} // namespace
+
+size_t CollisionSystem::intersectBatch(const SDL_Rect &box, const int32_t *x,
+                                       const int32_t *y, const int32_t *w,
+                                       const int32_t *h, size_t count,
+                                       uint64_t *mask) {
+  const size_t words = maskWords(count);
+  std::fill(mask, mask + words, 0);
+  if (box.w <= 0 || box.h <= 0 || count == 0)
+    return 0;
+  const Query query{box.x, box.y, box.x + box.w, box.y + box.h};
+  kernel()(query, x, y, w, h, count, mask);
+  return countBits(mask, words);
+}
+
+size_t CollisionSystem::intersectBatch(const BoxList &a, const BoxList &b,
+                                       std::vector<uint64_t> &masks) {
+  const size_t words = maskWords(b.size());
+  masks.resize(a.size() * words);
+  size_t hits = 0;
+  for (size_t i = 0; i < a.size(); ++i)
+    hits += intersectBatch(a.at(i), b, masks.data() + i * words);
+  return hits;
+}
@@ -1,4 +1,5 @@
 #include "CollisionSystem.hpp"
+#include "Game/Character.hpp"
 #include <SDL.h>
 
 bool CollisionSystem::checkCollision(const SDL_Rect &a, const SDL_Rect &b) {
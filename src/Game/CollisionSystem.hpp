@@ -1,12 +1,66 @@
 #pragma once
 #include "Data/Vector2f.hpp"
-#include "Game/Character.hpp"
 #include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Character;
+
+// Boxes as parallel columns, the layout intersectBatch() reads.
+struct BoxList {
+  std::vector<int32_t> x, y, w, h;
+
+  size_t size() const { return x.size(); }
+  void clear() {
+    for (std::vector<int32_t> *column : {&x, &y, &w, &h})
+      column->clear();
+  }
+  void resize(size_t count) {
+    for (std::vector<int32_t> *column : {&x, &y, &w, &h})
+      column->resize(count);
+  }
+  void set(size_t i, const SDL_Rect &box) {
+    x[i] = box.x;
+    y[i] = box.y;
+    w[i] = box.w;
+    h[i] = box.h;
+  }
+  void push(const SDL_Rect &box) {
+    x.push_back(box.x);
+    y.push_back(box.y);
+    w.push_back(box.w);
+    h.push_back(box.h);
+  }
+  SDL_Rect at(size_t i) const { return SDL_Rect{x[i], y[i], w[i], h[i]}; }
+};
 
 class CollisionSystem {
 public:
   static bool checkCollision(const SDL_Rect &a, const SDL_Rect &b);
 
+  // Number of uint64_t words in a hit mask for `count` boxes.
+  static size_t maskWords(size_t count) { return (count + 63) / 64; }
+
+  // Tests `box` against `count` boxes given as columns and sets bit i of
+  // `mask` (maskWords(count) words, overwritten) when it intersects box i,
+  // with the same rules as checkCollision: empty boxes never intersect.
+  // Returns the number of hits. Runs 8 boxes per step with AVX2 where the
+  // CPU has it, 4 with SSE2 or NEON.
+  static size_t intersectBatch(const SDL_Rect &box, const int32_t *x,
+                               const int32_t *y, const int32_t *w,
+                               const int32_t *h, size_t count,
+                               uint64_t *mask);
+  static size_t intersectBatch(const SDL_Rect &box, const BoxList &boxes,
+                               uint64_t *mask) {
+    return intersectBatch(box, boxes.x.data(), boxes.y.data(),
+                          boxes.w.data(), boxes.h.data(), boxes.size(), mask);
+  }
+  // Every box of `a` against every box of `b`. Row i of `masks` (each
+  // maskWords(b.size()) words) holds the hits of a[i].
+  static size_t intersectBatch(const BoxList &a, const BoxList &b,
+                               std::vector<uint64_t> &masks);
+
   static void resolveCollision(Character &a, Character &b);
 
   static void applyCollisionImpulse(Character &a, Character &b,
@@ -0,0 +1,59 @@
+#pragma once
+#include "Data/Vector2f.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+enum class CombatEventType : uint8_t {
+  Hit,      // source's attack connected with target
+  Block,    // target guarded source's attack
+  Whiff,    // source's attack ended without connecting
+  KO,       // target's health reached zero, from source's contact
+  RoundEnd, // the round is over; no fighters
+};
+
+// Something that happened in a fight. Fighters are FightSystem indices,
+// -1 where the event has none.
+struct CombatEvent {
+  explicit CombatEvent(CombatEventType type) : type(type) {}
+
+  CombatEventType type;
+  int source = -1;
+  int target = -1;
+  // Hit and Block: damage before the target's guard is applied, and the
+  // flat chip every registered contact deals on top of it.
+  int damage = 0;
+  int chipDamage = 0;
+  float knockback = 0.0f;
+  // Where the target stood when the event happened.
+  Vector2f position;
+};
+
+// The combat events of one tick, in the order they happened. Combat
+// appends them as it detects and resolves contacts; damage, reward, VFX
+// and telemetry then each read the whole tick in order instead of being
+// called back from the middle of hit detection. A queue lives for one tick
+// and usually allocates from the FrameArena.
+class CombatEventQueue {
+public:
+  explicit CombatEventQueue(
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : m_events(resource) {}
+
+  void push(const CombatEvent &event) { m_events.push_back(event); }
+
+  size_t size() const { return m_events.size(); }
+  bool empty() const { return m_events.empty(); }
+  const CombatEvent &operator[](size_t i) const { return m_events[i]; }
+
+  std::pmr::vector<CombatEvent>::const_iterator begin() const {
+    return m_events.begin();
+  }
+  std::pmr::vector<CombatEvent>::const_iterator end() const {
+    return m_events.end();
+  }
+
+private:
+  std::pmr::vector<CombatEvent> m_events;
+};
@@ -22,13 +22,25 @@ void CombatSystem::update(float deltaTime, Character &player,
   m_lastEnemyHealth = enemy.health;
 }
 
+void CombatSystem::captureInitialState(const Character &player,
+                                       const Character &enemy) {
+  m_initialState.player = spawnState(player, 200.0f);
+  m_initialState.enemy = spawnState(enemy, 600.0f);
+}
+
 void CombatSystem::startNewRound(Character &player, Character &enemy) {
-  m_roundTime = ROUND_DURATION;
+  m_roundTime = roundDuration();
   m_isRoundActive = true;
   m_roundCount++;
 
-  resetCharacter(player, Vector2f(200, 100));
-  resetCharacter(enemy, Vector2f(600, 100));
+  player.restore(m_initialState.player);
+  enemy.restore(m_initialState.enemy);
+  placeOnGround(player);
+  placeOnGround(enemy);
+  if (m_playerAgent)
+    m_playerAgent->beginEpisode(enemy);
+  if (m_enemyAgent)
+    m_enemyAgent->beginEpisode(player);
 }
 
 void CombatSystem::render(SDL_Renderer *renderer) {
@@ -75,26 +87,41 @@ void CombatSystem::endRound(Character &player, Character &enemy) {
   }
 
   if (m_playerAgent) {
+    m_playerAgent->endEpisode(enemy);
     m_playerAgent->reportWin(playerWon);
     m_playerAgent->incrementEpisodeCount();
   }
   if (m_enemyAgent) {
+    m_enemyAgent->endEpisode(player);
     m_enemyAgent->reportWin(!playerWon);
     m_enemyAgent->incrementEpisodeCount();
   }
 }
 
-void CombatSystem::resetCharacter(Character &character,
-                                  const Vector2f &position) {
+Character::Snapshot CombatSystem::spawnState(const Character &character,
+                                             float x) const {
+  Character::Snapshot state = character.snapshot();
   SDL_Rect charRect = character.animator->getCurrentFrameRect();
-  float groundedY = m_config.groundLevel - charRect.h;
+  state.position = Vector2f(x, m_config.groundLevel - charRect.h);
+  state.velocity = Vector2f(0, 0);
+  state.acceleration = Vector2f(0, 0);
+  state.health = character.maxHealth;
+  state.stamina = character.maxStamina;
+  state.onGround = true;
+  state.isMoving = false;
+  state.groundFrames = m_config.stableGroundFrames;
+  state.inputDirection = 0;
+  state.comboCount = 0;
+  state.state = CharacterState::Idle;
+  state.animationTimer = 0.0f;
+  return state;
+}
 
-  character.mover.position = Vector2f(position.x, groundedY);
-  character.mover.velocity = Vector2f(0, 0);
-  character.health = character.maxHealth;
-  character.onGround = true;
+void CombatSystem::placeOnGround(Character &character) const {
+  SDL_Rect charRect = character.animator->getCurrentFrameRect();
+  character.mover.position.y =
+      static_cast<float>(m_config.groundLevel - charRect.h);
   character.groundFrames = m_config.stableGroundFrames;
-  character.animator->play("Idle");
 }
 
 void CombatSystem::renderTimer(SDL_Renderer *renderer) {
@@ -103,7 +130,7 @@ void CombatSystem::renderTimer(SDL_Renderer *renderer) {
   SDL_Rect bgRect = {350, 10, 100, 30};
   SDL_RenderFillRect(renderer, &bgRect);
 
-  float timeRatio = m_roundTime / ROUND_DURATION;
+  float timeRatio = m_roundTime / roundDuration();
   SDL_SetRenderDrawColor(renderer, static_cast<Uint8>(255 * (1.0f - timeRatio)),
                          static_cast<Uint8>(255 * timeRatio), 0, 255);
   SDL_Rect timerRect = {bgRect.x + 2, bgRect.y + 2,
@@ -123,5 +150,5 @@ void CombatSystem::renderRoundInfo(SDL_Renderer *renderer) {
 }
 void CombatSystem::setTrainingMode(bool enabled) {
   m_trainingMode = enabled;
-  m_roundTime = enabled ? TRAINING_ROUND_DURATION : NORMAL_ROUND_DURATION;
+  m_roundTime = roundDuration();
 }
@@ -4,6 +4,13 @@
 #include "Game/Character.hpp"
 #include <SDL.h>
 
+// Everything startNewRound() resets, captured once so that starting a round
+// is a copy instead of replaying the setup.
+struct MatchState {
+  Character::Snapshot player;
+  Character::Snapshot enemy;
+};
+
 class CombatSystem {
 public:
   static constexpr float ROUND_DURATION = 60.0f;
@@ -14,6 +21,12 @@ public:
 
   void update(float deltaTime, Character &player, Character &enemy);
 
+  // Builds the round template from the fighters' current state (spawn
+  // positions are overridden), e.g. right after they are created. Must be
+  // called before the first startNewRound().
+  void captureInitialState(const Character &player, const Character &enemy);
+  // Puts both fighters back to the template and starts a new episode for
+  // each agent.
   void startNewRound(Character &player, Character &enemy);
   void setTrainingMode(bool enabled);
   bool &trainingMode() { return m_trainingMode; }
@@ -27,7 +40,14 @@ public:
 private:
   void endRound(Character &player, Character &enemy);
 
-  void resetCharacter(Character &character, const Vector2f &position);
+  // `character` standing on the ground at `x` with full health.
+  Character::Snapshot spawnState(const Character &character, float x) const;
+  // Re-applies the ground level and settle time from the live config, which
+  // the editor may have changed since the template was captured.
+  void placeOnGround(Character &character) const;
+  float roundDuration() const {
+    return m_trainingMode ? TRAINING_ROUND_DURATION : NORMAL_ROUND_DURATION;
+  }
 
   void renderTimer(SDL_Renderer *renderer);
 
@@ -43,6 +63,7 @@ private:
   float m_timeSinceLastDamage = 0.0f;
   int m_lastPlayerHealth = 100;
   int m_lastEnemyHealth = 100;
+  MatchState m_initialState;
 
   RLAgent *m_enemyAgent = nullptr;
   RLAgent *m_playerAgent = nullptr;
@@ -2,86 +2,208 @@
 #include "Data/Animation.hpp"
 #include "Game/CollisionSystem.hpp"
 #include <SDL.h>
+#include <algorithm>
 #include <string>
+#include <utility>
 
-bool FightSystem::processHit(Character &attacker, Character &defender) {
+namespace {
+SDL_Rect worldHitBox(const Character &attacker, const HitboxTable &table,
+                     int index) {
+  SDL_Rect rect = table.hitBox(index, attacker.animator->getFlip());
+  rect.x += static_cast<int>(attacker.mover.position.x);
+  rect.y += static_cast<int>(attacker.mover.position.y);
+  return rect;
+}
+} // namespace
 
-  std::string currentAnimationKey = attacker.animator->getCurrentAnimationKey();
+int FightSystem::addFighter(Character &character) {
+  const size_t count = m_fighters.size();
+  std::vector<HitRegistration> grown((count + 1) * (count + 1));
+  for (size_t a = 0; a < count; ++a)
+    for (size_t d = 0; d < count; ++d)
+      grown[a * (count + 1) + d] = m_hitRegistrations[a * count + d];
+  m_hitRegistrations = std::move(grown);
+  m_fighters.push_back(&character);
+  m_attacks.emplace_back();
+  return static_cast<int>(count);
+}
 
-  auto hitKey = std::make_pair(&attacker, &defender);
-  auto &hitReg = m_hitRegistrations[hitKey];
+void FightSystem::clearFighters() {
+  m_fighters.clear();
+  m_attacks.clear();
+  m_hitRegistrations.clear();
+}
 
-  if (hitReg.currentAttackAnimation == currentAnimationKey &&
-      hitReg.hitCooldown > 0) {
-    return false;
-  }
+void FightSystem::resetRound() {
+  std::fill(m_attacks.begin(), m_attacks.end(), AttackTrack{});
+  std::fill(m_hitRegistrations.begin(), m_hitRegistrations.end(),
+            HitRegistration{});
+}
 
-  const std::vector<Hitbox> &hitboxes = attacker.animator->getCurrentHitboxes();
-  SDL_Rect defenderHurtbox = defender.getHitboxRect();
-  SDL_Rect defenderBlockBox = defender.getHitboxRect(HitboxType::Block);
-  SDL_Rect attackerFrameRect = attacker.animator->getCurrentFrameRect();
-  bool isAttackerFlipped = attacker.animator->getFlip();
+void FightSystem::findCandidates() {
+  const int count = static_cast<int>(m_fighters.size());
+  m_broadPhase.clear();
+  for (int index = 0; index < count; ++index) {
+    Character &character = *m_fighters[index];
+    m_broadPhase.add(character.getHitboxRect(), index, BodyLayer, 0);
+    m_broadPhase.add(character.getHitboxRect(HitboxType::Block), index,
+                     GuardLayer, 0);
 
-  for (const auto &hb : hitboxes) {
-    if (!hb.enabled || hb.type != HitboxType::Hit)
+    const HitboxTable &table = character.animator->getHitboxTable();
+    const int frame = character.animator->getCurrentFrameIndex();
+    if (frame < 0 || frame + 1 >= static_cast<int>(table.hitBegin.size()))
       continue;
+    for (int i = table.hitBegin[frame]; i < table.hitBegin[frame + 1]; ++i)
+      m_broadPhase.add(worldHitBox(character, table, i), index, AttackLayer,
+                       BodyLayer | GuardLayer);
+  }
 
-    SDL_Rect hbRect;
-    if (isAttackerFlipped) {
-      hbRect.x = static_cast<int>(attacker.mover.position.x +
-                                  (attackerFrameRect.w - (hb.x + hb.w)));
-    } else {
-      hbRect.x = static_cast<int>(attacker.mover.position.x + hb.x);
+  m_candidates.assign(m_hitRegistrations.size(), 0);
+  for (const BroadPhase::Pair &pair : m_broadPhase.findPairs()) {
+    // Only attack boxes have a mask, so exactly one side is the attack.
+    int attacker = pair.a;
+    int defender = pair.b;
+    if (m_broadPhase.layer(attacker) != AttackLayer)
+      std::swap(attacker, defender);
+    m_candidates[m_broadPhase.owner(attacker) * count +
+                 m_broadPhase.owner(defender)] = 1;
+  }
+}
+
+void FightSystem::detectHits(CombatEventQueue &events) {
+  findCandidates();
+  trackAttacks(events);
+  const int count = static_cast<int>(m_fighters.size());
+  for (int attacker = 0; attacker < count; ++attacker)
+    for (int defender = 0; defender < count; ++defender)
+      if (m_candidates[attacker * count + defender])
+        processHit(attacker, defender, events);
+}
+
+void FightSystem::trackAttacks(CombatEventQueue &events) {
+  for (size_t index = 0; index < m_fighters.size(); ++index) {
+    const Animator &animator = *m_fighters[index]->animator;
+    const HitboxTable &table = animator.getHitboxTable();
+    const int frame = animator.getCurrentFrameIndex();
+    const bool active =
+        frame >= 0 && frame + 1 < static_cast<int>(table.hitBegin.size()) &&
+        table.hitBegin[frame] < table.hitBegin[frame + 1];
+    const int animation = animator.getCurrentAnimationId();
+
+    AttackTrack &track = m_attacks[index];
+    if (track.animation != -1 && (!active || animation != track.animation)) {
+      if (!track.connected) {
+        CombatEvent whiff{CombatEventType::Whiff};
+        whiff.source = static_cast<int>(index);
+        events.push(whiff);
+      }
+      track = AttackTrack{};
     }
-    hbRect.y = static_cast<int>(attacker.mover.position.y + hb.y);
-    hbRect.w = hb.w;
-    hbRect.h = hb.h;
+    if (active && track.animation == -1)
+      track.animation = animation;
+  }
+}
 
-    if (CollisionSystem::checkCollision(hbRect, defenderBlockBox)) {
-      defender.applyDamage(25, true);
-      defender.block();
-      defender.lastBlockEffective = true;
-      attacker.lastAttackLanded = false;
+bool FightSystem::processHit(int attackerIndex, int defenderIndex,
+                             CombatEventQueue &events) {
+  Character &attacker = *m_fighters[attackerIndex];
+  Character &defender = *m_fighters[defenderIndex];
+  const int attackAnimation = attacker.animator->getCurrentAnimationId();
+
+  HitRegistration &hitReg = registration(attackerIndex, defenderIndex);
+  if (hitReg.attackAnimation == attackAnimation && hitReg.hitCooldown > 0) {
+    return false;
+  }
+
+  const HitboxTable &table = attacker.animator->getHitboxTable();
+  const int frame = attacker.animator->getCurrentFrameIndex();
+  if (frame < 0 || frame + 1 >= static_cast<int>(table.hitBegin.size()))
+    return false;
+
+  // Test all of the frame's hit boxes against both defender boxes at once,
+  // then resolve them in box order; on the same box, guard beats body.
+  m_attackBoxes.clear();
+  for (int i = table.hitBegin[frame]; i < table.hitBegin[frame + 1]; ++i)
+    m_attackBoxes.push(worldHitBox(attacker, table, i));
+  const size_t words = CollisionSystem::maskWords(m_attackBoxes.size());
+  m_blockMask.resize(words);
+  m_hurtMask.resize(words);
+  const size_t blocked = CollisionSystem::intersectBatch(
+      defender.getHitboxRect(HitboxType::Block), m_attackBoxes,
+      m_blockMask.data());
+  const size_t hits = CollisionSystem::intersectBatch(
+      defender.getHitboxRect(), m_attackBoxes, m_hurtMask.data());
+  if (blocked == 0 && hits == 0)
+    return false;
 
-      hitReg.hitCooldown = HIT_COOLDOWN_DURATION;
-      hitReg.currentAttackAnimation = currentAnimationKey;
-      return true;
+  CombatEvent event{CombatEventType::Hit};
+  event.source = attackerIndex;
+  event.target = defenderIndex;
+  event.chipDamage = CHIP_DAMAGE;
+  event.position = defender.mover.position;
+  for (size_t i = 0; i < m_attackBoxes.size(); ++i) {
+    const uint64_t bit = uint64_t{1} << (i % 64);
+    if (m_blockMask[i / 64] & bit) {
+      event.type = CombatEventType::Block;
+      event.damage = BLOCK_DAMAGE;
+    } else if (m_hurtMask[i / 64] & bit) {
+      const float baseImpulse = 500.0f;
+      event.damage = static_cast<int>(50 * attacker.comboCount * 1.25f);
+      event.knockback = baseImpulse * (1.0f + attacker.comboCount * 0.1f);
+    } else {
+      continue;
     }
 
-    if (CollisionSystem::checkCollision(hbRect, defenderHurtbox)) {
-      int randomHitAnimation = rand() % 3 + 1;
-      if (randomHitAnimation == 1) {
-        defender.animator->play("Hit");
-      } else {
-        defender.animator->play("Hit " + std::to_string(randomHitAnimation));
-      }
-      attacker.lastAttackLanded = true;
-      defender.lastBlockEffective = false;
+    events.push(event);
+    m_attacks[attackerIndex].connected = true;
+    hitReg.hitCooldown = HIT_COOLDOWN_DURATION;
+    hitReg.attackAnimation = attackAnimation;
+    return true;
+  }
+  return false;
+}
+
+void FightSystem::applyHits(CombatEventQueue &events) {
+  // KO events are appended behind the contacts that caused them.
+  const size_t count = events.size();
+  for (size_t i = 0; i < count; ++i) {
+    const CombatEvent event = events[i];
+    if (event.type != CombatEventType::Hit &&
+        event.type != CombatEventType::Block)
+      continue;
+    Character &attacker = *m_fighters[event.source];
+    Character &defender = *m_fighters[event.target];
+    const bool standing = defender.health > 0;
 
-      float baseImpulse = 500.0f;
-      defender.applyDamage(50 * attacker.comboCount * 1.25f);
-      float knockbackForce = baseImpulse * (1.0f + attacker.comboCount * 0.1f);
+    if (event.type == CombatEventType::Block) {
+      defender.applyDamage(event.damage, true);
+      defender.block();
+    } else {
+      static const char *const HIT_ANIMATIONS[] = {"Hit", "Hit 2", "Hit 3"};
+      defender.animator->play(HIT_ANIMATIONS[rand() % 3]);
+      defender.applyDamage(event.damage);
       CollisionSystem::applyCollisionImpulse(attacker, defender,
-                                             knockbackForce);
+                                             event.knockback);
+    }
+    if (event.chipDamage > 0)
+      defender.applyDamage(event.chipDamage);
 
-      hitReg.hitCooldown = HIT_COOLDOWN_DURATION;
-      hitReg.currentAttackAnimation = currentAnimationKey;
-      return true;
+    if (standing && defender.health <= 0) {
+      CombatEvent knockout{CombatEventType::KO};
+      knockout.source = event.source;
+      knockout.target = event.target;
+      knockout.position = defender.mover.position;
+      events.push(knockout);
     }
   }
-  return false;
 }
 
 void FightSystem::update(float deltaTime) {
-
-  for (auto &pair : m_hitRegistrations) {
-    auto &hitReg = pair.second;
+  for (HitRegistration &hitReg : m_hitRegistrations) {
     if (hitReg.hitCooldown > 0) {
       hitReg.hitCooldown -= deltaTime;
-      if (hitReg.hitCooldown <= 0) {
-
-        hitReg.currentAttackAnimation.clear();
-      }
+      if (hitReg.hitCooldown <= 0)
+        hitReg.attackAnimation = -1;
     }
   }
 }
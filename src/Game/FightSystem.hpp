@@ -1,24 +1,79 @@
 #pragma once
+#include "Game/BroadPhase.hpp"
 #include "Game/Character.hpp"
+#include "Game/CollisionSystem.hpp"
+#include "Game/CombatEvents.hpp"
+#include <vector>
 
+// Hit detection and resolution for the fighters of one match. Fighters are
+// registered once and then addressed by index; hit registrations live in a
+// dense fighter x fighter table, so a lookup is an index and nothing
+// allocates per tick. Each match owns its own FightSystem.
 class FightSystem {
 public:
-  bool processHit(Character &attacker, Character &defender);
+  // Returns the fighter's index, used by processHit and in CombatEvents.
+  int addFighter(Character &character);
+  void clearFighters();
+  // Forgets the attacks in flight and the hit cooldowns, e.g. when the
+  // fighters are put back to their spawn state; fighters stay registered.
+  void resetRound();
+  size_t fighterCount() const { return m_fighters.size(); }
+  Character &fighter(int index) { return *m_fighters[index]; }
+
+  // Registers a contact of `attacker` on `defender`, if any, as a Hit or
+  // Block event. Nothing is applied to either fighter yet.
+  bool processHit(int attacker, int defender, CombatEventQueue &events);
+  // Tests the attacker/defender pairs whose boxes the broad phase found
+  // overlapping, in index order, and appends this tick's Hit, Block and
+  // Whiff events. Every pair sees the fighters as they were at the start
+  // of the tick, so two fighters hitting each other both register.
+  void detectHits(CombatEventQueue &events);
+  // Damage stage: applies the Hit and Block events of the tick to their
+  // targets (health, guard, hit reactions, knockback) in order, and
+  // appends a KO event for every fighter they knock out.
+  void applyHits(CombatEventQueue &events);
+
   void update(float deltaTime);
 
 private:
   // Track when a hit was last registered for each attacker-defender pair
   struct HitRegistration {
     float hitCooldown = 0.0f; // Time until next hit can be registered
-    std::string
-        currentAttackAnimation; // Track which attack animation caused the hit
+    int attackAnimation = -1; // Animator id of the attack that hit
+  };
+
+  // The attack a fighter is in, from its first frame with hit boxes until
+  // it leaves them, and whether it registered a contact on the way.
+  struct AttackTrack {
+    int animation = -1;
+    bool connected = false;
   };
 
-  // Use a map to track hit registration between characters
-  // The key is a pair of pointers to identify unique attacker-defender
-  // combinations
-  std::map<std::pair<Character *, Character *>, HitRegistration>
-      m_hitRegistrations;
+  std::vector<Character *> m_fighters;
+  std::vector<AttackTrack> m_attacks;
+  // Row-major: registration(attacker, defender) is at
+  // attacker * fighterCount() + defender.
+  std::vector<HitRegistration> m_hitRegistrations;
+
+  BroadPhase m_broadPhase;
+  // Same layout as m_hitRegistrations; set by findCandidates().
+  std::vector<uint8_t> m_candidates;
+
+  // processHit scratch, reused so a tick does not allocate.
+  BoxList m_attackBoxes;
+  std::vector<uint64_t> m_blockMask;
+  std::vector<uint64_t> m_hurtMask;
+
+  void findCandidates();
+  void trackAttacks(CombatEventQueue &events);
+
+  HitRegistration &registration(int attacker, int defender) {
+    return m_hitRegistrations[static_cast<size_t>(attacker) *
+                                  m_fighters.size() +
+                              defender];
+  }
 
   static constexpr float HIT_COOLDOWN_DURATION = 0.5f;
+  static constexpr int BLOCK_DAMAGE = 25;
+  static constexpr int CHIP_DAMAGE = 1;
 };
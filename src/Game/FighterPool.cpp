@@ -0,0 +1,162 @@
+#include "FighterPool.hpp"
+#include "AI/Kernels.hpp"
+#include <cmath>
+#include <stdexcept>
+
+FighterPool::FighterPool(size_t capacity)
+    : positionX(new float[capacity]), positionY(new float[capacity]),
+      velocityX(new float[capacity]), velocityY(new float[capacity]),
+      accelerationX(new float[capacity]), accelerationY(new float[capacity]),
+      mass(new float[capacity]), friction(new float[capacity]),
+      health(new int[capacity]), maxHealth(new int[capacity]),
+      stamina(new float[capacity]), maxStamina(new float[capacity]),
+      onGround(new bool[capacity]), isMoving(new bool[capacity]),
+      groundFrames(new int[capacity]),
+      playback(new AnimationPlayback[capacity]), m_capacity(capacity),
+      m_grounded(new float[capacity]), m_extentX(new float[capacity]),
+      m_extentY(new float[capacity]), m_landed(new float[capacity]),
+      m_airborne(new float[capacity]), m_decay(new float[capacity]),
+      m_decayFriction(new float[capacity]) {}
+
+int FighterPool::add() {
+  if (m_size == m_capacity)
+    throw std::length_error("FighterPool is full");
+  const size_t i = m_size++;
+  positionX[i] = positionY[i] = 0.0f;
+  velocityX[i] = velocityY[i] = 0.0f;
+  accelerationX[i] = accelerationY[i] = 0.0f;
+  mass[i] = 1.0f;
+  friction[i] = 2.0f;
+  health[i] = maxHealth[i] = 100;
+  stamina[i] = maxStamina[i] = 500.0f;
+  onGround[i] = false;
+  isMoving[i] = false;
+  groundFrames[i] = 0;
+  playback[i] = AnimationPlayback{};
+  m_decay[i] = std::exp(-friction[i] * m_decayDeltaTime);
+  m_decayFriction[i] = friction[i];
+  return static_cast<int>(i);
+}
+
+int FighterPool::collisionHeight(size_t index) const {
+  const AnimationPlayback &state = playback[index];
+  if (!state.animation || state.animation->frames.empty())
+    return 0;
+  int height = state.animation->hitboxes
+                   .bounds(state.frame, HitboxType::Collision, state.flip)
+                   .h;
+  if (height == 0)
+    height = state.animation->frames[state.frame].frameRect.h;
+  return height;
+}
+
+void FighterPool::refreshDecay(float deltaTime) {
+  const bool retick = deltaTime != m_decayDeltaTime;
+  for (size_t i = 0; i < m_size; ++i) {
+    if (retick || friction[i] != m_decayFriction[i]) {
+      m_decay[i] = std::exp(-friction[i] * deltaTime);
+      m_decayFriction[i] = friction[i];
+    }
+  }
+  m_decayDeltaTime = deltaTime;
+}
+
+void FighterPool::step(float deltaTime, const Config &config) {
+  for (size_t i = 0; i < m_size; ++i) {
+    m_grounded[i] = onGround[i] ? 1.0f : 0.0f;
+    m_extentY[i] = static_cast<float>(collisionHeight(i));
+  }
+  refreshDecay(deltaTime);
+
+  // Branches become 0/1 masks m and choices become a * m + b * (1 - m),
+  // which is exact because one product is zero and the other is a * 1.
+  const float gravity = config.gravity;
+  const float ground = static_cast<float>(config.groundLevel);
+  const float liftOff = ground - static_cast<float>(config.groundThreshold);
+  const float staminaGain = STAMINA_RECOVERY_RATE * deltaTime;
+  simd::forEach(m_size, [&](size_t i, auto lane) {
+    using V = decltype(lane);
+    const V one = simd::splat<V>(1.0f);
+    const V zero = simd::splat<V>(0.0f);
+    const V dt = simd::splat<V>(deltaTime);
+
+    V ax = simd::loadAs<V>(accelerationX.get() + i);
+    V ay = simd::loadAs<V>(accelerationY.get() + i);
+    V vx = simd::loadAs<V>(velocityX.get() + i);
+    V vy = simd::loadAs<V>(velocityY.get() + i);
+    V px = simd::loadAs<V>(positionX.get() + i);
+    V py = simd::loadAs<V>(positionY.get() + i);
+    const V height = simd::loadAs<V>(m_extentY.get() + i);
+
+    // Gravity pulls whoever was airborne at the start of the tick.
+    const V airborneBefore = one - simd::loadAs<V>(m_grounded.get() + i);
+    ay = ay + airborneBefore * (simd::splat<V>(gravity) *
+                                (one / simd::loadAs<V>(mass.get() + i)));
+
+    // Ground: snap onto it and stop falling, or leave it past the margin.
+    const V bottom = py + height;
+    const V landed = one - simd::positive(simd::splat<V>(ground) - bottom);
+    const V airborne = simd::positive(simd::splat<V>(liftOff) - bottom);
+    py = (simd::splat<V>(ground) - height) * landed + py * (one - landed);
+    vy = vy * (one - landed);
+
+    const V gained = simd::loadAs<V>(stamina.get() + i) +
+                     simd::splat<V>(staminaGain);
+    simd::store(stamina.get() + i,
+                simd::min(simd::loadAs<V>(maxStamina.get() + i), gained));
+
+    vx = vx + ax * dt;
+    vy = vy + ay * dt;
+    vx = vx * simd::loadAs<V>(m_decay.get() + i);
+    simd::store(velocityX.get() + i, vx);
+    simd::store(velocityY.get() + i, vy);
+    simd::store(positionX.get() + i, px + vx * dt);
+    simd::store(positionY.get() + i, py + vy * dt);
+    simd::store(accelerationX.get() + i, zero);
+    simd::store(accelerationY.get() + i, zero);
+    simd::store(m_landed.get() + i, landed);
+    simd::store(m_airborne.get() + i, airborne);
+  });
+
+  for (size_t i = 0; i < m_size; ++i) {
+    if (m_landed[i] != 0.0f) {
+      onGround[i] = true;
+      groundFrames[i]++;
+    } else if (m_airborne[i] != 0.0f) {
+      onGround[i] = false;
+      groundFrames[i] = 0;
+    }
+  }
+
+  for (size_t i = 0; i < m_size; ++i)
+    Animator::advance(playback[i], deltaTime);
+}
+
+void FighterPool::clampToArena(float width, float height, float groundLevel) {
+  for (size_t i = 0; i < m_size; ++i) {
+    const AnimationPlayback &state = playback[i];
+    SDL_Rect frame{0, 0, 0, 0};
+    if (state.animation && !state.animation->frames.empty())
+      frame = state.animation->frames[state.frame].frameRect;
+    m_extentX[i] = width - static_cast<float>(frame.w);
+    m_extentY[i] = height - static_cast<float>(frame.h);
+  }
+
+  // clamp(v, 0, max) from Maths.hpp: 0 wins over max when they cross.
+  simd::forEach(m_size, [&](size_t i, auto lane) {
+    using V = decltype(lane);
+    const V one = simd::splat<V>(1.0f);
+    const V zero = simd::splat<V>(0.0f);
+    auto clampLane = [&](V value, V upper) {
+      const V below = simd::positive(zero - value);
+      return zero * below + simd::min(value, upper) * (one - below);
+    };
+    const V px = simd::loadAs<V>(positionX.get() + i);
+    const V py = simd::loadAs<V>(positionY.get() + i);
+    simd::store(positionX.get() + i,
+                clampLane(px, simd::loadAs<V>(m_extentX.get() + i)));
+    simd::store(positionY.get() + i,
+                simd::min(clampLane(py, simd::loadAs<V>(m_extentY.get() + i)),
+                          simd::splat<V>(groundLevel)));
+  });
+}
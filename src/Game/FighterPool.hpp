@@ -0,0 +1,80 @@
+#pragma once
+#include "Core/Config.hpp"
+#include "Data/Vector2f.hpp"
+#include "Rendering/Animator.hpp"
+#include <cstddef>
+#include <memory>
+
+// Simulation state of many fighters as parallel arrays, one slot per
+// fighter, so the per-tick systems below are linear passes over contiguous
+// memory whether the pool holds one match or hundreds. Character is a view
+// of one slot (its Mover, health, stamina and flags are references into
+// these arrays) and an attached Animator keeps its playback here.
+//
+// Capacity is fixed at construction, so slots never move and views stay
+// valid until clear().
+class FighterPool {
+public:
+  template <typename T> using Column = std::unique_ptr<T[]>;
+
+  explicit FighterPool(size_t capacity);
+
+  FighterPool(const FighterPool &) = delete;
+  FighterPool &operator=(const FighterPool &) = delete;
+
+  // Claims the next slot, reset to a fresh fighter. Throws
+  // std::length_error when the pool is full.
+  int add();
+  // Releases every slot; views of them must not be used afterwards.
+  void clear() { m_size = 0; }
+
+  size_t size() const { return m_size; }
+  size_t capacity() const { return m_capacity; }
+
+  Column<float> positionX, positionY;
+  Column<float> velocityX, velocityY;
+  Column<float> accelerationX, accelerationY;
+  Column<float> mass;
+  Column<float> friction;
+  Column<int> health;
+  Column<int> maxHealth;
+  Column<float> stamina;
+  Column<float> maxStamina;
+  Column<bool> onGround;
+  Column<bool> isMoving;
+  Column<int> groundFrames;
+  Column<AnimationPlayback> playback;
+
+  // One tick for every fighter: gravity, ground clamping, stamina
+  // regeneration and integration (forces, friction decay, motion) run as a
+  // single SIMD pass over the columns, then animations advance. Results
+  // match a Mover::update per fighter exactly.
+  void step(float deltaTime, const Config &config);
+
+  // Keeps every fighter's current frame inside [0, width) x [0, height)
+  // and no lower than `groundLevel`, as one SIMD pass.
+  void clampToArena(float width, float height, float groundLevel);
+
+  static constexpr float STAMINA_RECOVERY_RATE = 50.0f;
+
+private:
+  size_t m_capacity;
+  size_t m_size = 0;
+
+  // Per-tick scratch, gathered from the non-float columns so the SIMD
+  // passes only see floats. m_decay caches exp(-friction * dt) and is only
+  // recomputed when the tick length or that fighter's friction changes.
+  Column<float> m_grounded;
+  Column<float> m_extentX;
+  Column<float> m_extentY;
+  Column<float> m_landed;
+  Column<float> m_airborne;
+  Column<float> m_decay;
+  Column<float> m_decayFriction;
+  float m_decayDeltaTime = 0.0f;
+
+  // Height of the collision box in the current frame, or of the frame when
+  // it has none.
+  int collisionHeight(size_t index) const;
+  void refreshDecay(float deltaTime);
+};
@@ -2,22 +2,26 @@
 #include "AI/NeuralNetworkTreeView.hpp"
 #include "AI/NeuralNetworkVisualizer.hpp"
 #include "Core/DebugDraw.hpp"
-#include "Core/DebugEvents.hpp"
 #include "Core/DebugGlobals.hpp"
+#include "Core/FrameArena.hpp"
 #include "Core/GuiContext.hpp"
 #include "Core/Input.hpp"
 #include "Core/Logger.hpp"
 #include "Core/Maths.hpp"
+#include "Core/MemoryTracker.hpp"
+#include "Core/Metrics.hpp"
 #include "Data/Animation.hpp"
 #include "Game/CollisionSystem.hpp"
 #include "Rendering/ConfigEditor.hpp"
 #include "Rendering/DebugOverlay.hpp"
+#include "Rendering/TelemetryPanel.hpp"
 #include "Rendering/Text.hpp"
 #include "Resources/PiksyAnimationLoader.hpp"
 #include "Resources/R.hpp"
 #include "imgui.h"
 #include "imgui_internal.h"
 #include <SDL.h>
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -38,6 +42,9 @@ void Game::init() {
 
   m_combatSystem = std::make_unique<CombatSystem>(
       m_config, m_player_agent.get(), m_enemy_agent.get());
+  m_combatSystem->captureInitialState(*m_player, *m_enemy);
+  m_player_agent->beginEpisode(*m_enemy);
+  m_enemy_agent->beginEpisode(*m_player);
 
   static GuiContext::Config config;
   config.iniFilename = R::config("game_imgui.ini");
@@ -70,6 +77,7 @@ void Game::initBackground() {
 }
 
 void Game::initAnimations() {
+  MemoryTracker::Scope memoryScope(MemorySubsystem::Animation);
   auto texture = m_resourceManager->getTexture(R::texture("alex.png"));
 
   std::map<std::string, Animation> loadedAnimations;
@@ -91,11 +99,22 @@ void Game::initAnimations() {
 }
 
 void Game::initCharacters() {
-  m_player = std::make_unique<Character>(m_animatorPlayer.get(), m_config);
-  m_enemy = std::make_unique<Character>(m_animatorEnemy.get(), m_config);
-
-  m_enemy_agent = std::make_unique<RLAgent>(m_enemy.get(), m_config);
-  m_player_agent = std::make_unique<RLAgent>(m_player.get(), m_config);
+  m_fighterPool.clear();
+  m_player = std::make_unique<Character>(m_animatorPlayer.get(), m_config,
+                                         m_fighterPool);
+  m_enemy = std::make_unique<Character>(m_animatorEnemy.get(), m_config,
+                                        m_fighterPool);
+  m_fightSystem.clearFighters();
+  m_playerFighter = m_fightSystem.addFighter(*m_player);
+  m_enemyFighter = m_fightSystem.addFighter(*m_enemy);
+
+  {
+    MemoryTracker::Scope memoryScope(MemorySubsystem::AI);
+    m_enemy_agent = std::make_unique<RLAgent>(m_enemy.get(), m_config);
+    m_player_agent = std::make_unique<RLAgent>(m_player.get(), m_config);
+    m_enemy_agent->initCheckpoints("enemy");
+    m_player_agent->initCheckpoints("player");
+  }
 
   SDL_Rect playerRect = m_player->animator->getCurrentFrameRect();
   SDL_Rect enemyRect = m_enemy->animator->getCurrentFrameRect();
@@ -151,12 +170,14 @@ void Game::run() {
         game->processInput();
         game->update(game->m_deltaTime);
         game->updateCamera(game->m_deltaTime);
+        Metrics::sample();
 
         game->render();
 
         game->renderDebugUI();
 
         game->m_imguiContext->endFrame();
+        game->endFrame();
       },
       this, 0, 1);
 #else
@@ -221,13 +242,19 @@ void Game::run() {
       update(m_deltaTime);
     }
 
+    Metrics::sample();
+
     if (!m_headlessMode) {
       updateCamera(m_deltaTime);
       render();
       renderDebugUI();
       m_imguiContext->endFrame();
     }
+
+    endFrame();
   }
+
+  MemoryTracker::dump();
 #endif
 }
 
@@ -243,6 +270,7 @@ void Game::single_iter(void *arg) {
   game->update(m_deltaTime);
   game->updateCamera(m_deltaTime);
   game->render();
+  game->endFrame();
 }
 
 void Game::processInput() { m_player->handleInput(); }
@@ -253,7 +281,11 @@ void Game::update(float deltaTime) {
 
   deltaTime *= m_timeScale;
 
+  CombatEventQueue events(&FrameArena::local());
+  const bool roundWasActive = m_combatSystem->isRoundActive();
   m_combatSystem->update(deltaTime, *m_player, *m_enemy);
+  if (roundWasActive && !m_combatSystem->isRoundActive())
+    events.push(CombatEvent{CombatEventType::RoundEnd});
 
   if (m_combatSystem->isRoundActive()) {
     m_fightSystem.update(deltaTime);
@@ -285,46 +317,84 @@ void Game::update(float deltaTime) {
       }
     }
 
-    m_player->update(deltaTime);
-    m_enemy->update(deltaTime);
+    m_player->updateAnimationTimeout(deltaTime);
+    m_enemy->updateAnimationTimeout(deltaTime);
+    m_fighterPool.step(deltaTime, m_config);
+    m_player->updateAnimationState();
+    m_enemy->updateAnimationState();
 
     m_player->updateFacing(*m_enemy);
     m_enemy->updateFacing(*m_player);
 
-    auto clampCharacter = [this](Character &ch) {
-      SDL_Rect r = ch.animator->getCurrentFrameRect();
-      ch.mover.position.x =
-          clamp(ch.mover.position.x, 0.f, float(m_config.windowWidth - r.w));
-      ch.mover.position.y =
-          clamp(ch.mover.position.y, 0.f, float(m_config.windowHeight - r.h));
-      if (ch.mover.position.y > m_config.groundLevel)
-        ch.mover.position.y = m_config.groundLevel;
-    };
-
-    clampCharacter(*m_player);
-    clampCharacter(*m_enemy);
-
-    if (m_fightSystem.processHit(*m_player, *m_enemy)) {
-      m_enemy->applyDamage(1);
-      Logger::debug("Player hit enemy!");
+    m_fighterPool.clampToArena(static_cast<float>(m_config.windowWidth),
+                               static_cast<float>(m_config.windowHeight),
+                               static_cast<float>(m_config.groundLevel));
+
+    m_fightSystem.detectHits(events);
+    m_fightSystem.applyHits(events);
+
+    m_bodyPhase.clear();
+    const int fighters = static_cast<int>(m_fightSystem.fighterCount());
+    for (int i = 0; i < fighters; ++i)
+      m_bodyPhase.add(m_fightSystem.fighter(i).getHitboxRect(), i, BodyLayer,
+                      BodyLayer);
+    for (const BroadPhase::Pair &pair : m_bodyPhase.findPairs()) {
+      Character &a = m_fightSystem.fighter(m_bodyPhase.owner(pair.a));
+      Character &b = m_fightSystem.fighter(m_bodyPhase.owner(pair.b));
+      CollisionSystem::resolveCollision(a, b);
+      CollisionSystem::applyCollisionImpulse(a, b, m_config.moveForce);
     }
+  } else {
+    startNewRound();
+  }
 
-    if (m_fightSystem.processHit(*m_enemy, *m_player)) {
-      m_player->applyDamage(1);
-      Logger::debug("Enemy hit player!");
-    }
+  dispatchCombatEvents(events);
+}
 
-    if (CollisionSystem::checkCollision(m_player->getHitboxRect(),
-                                        m_enemy->getHitboxRect())) {
-      CollisionSystem::resolveCollision(*m_player, *m_enemy);
-      CollisionSystem::applyCollisionImpulse(*m_player, *m_enemy,
-                                             m_config.moveForce);
-    }
-  } else {
-    m_combatSystem->startNewRound(*m_player, *m_enemy);
+void Game::dispatchCombatEvents(const CombatEventQueue &events) {
+  // In CombatEventType order.
+  static Counter *const counters[] = {
+      &Metrics::counter(MetricNames::CombatHits),
+      &Metrics::counter(MetricNames::CombatBlocks),
+      &Metrics::counter(MetricNames::CombatWhiffs),
+      &Metrics::counter(MetricNames::CombatKOs),
+      &Metrics::counter(MetricNames::CombatRounds),
+  };
+
+  if (m_player_agent)
+    m_player_agent->observeCombatEvents(events, m_playerFighter);
+  if (m_enemy_agent)
+    m_enemy_agent->observeCombatEvents(events, m_enemyFighter);
+
+  for (const CombatEvent &event : events) {
+    counters[static_cast<int>(event.type)]->increment();
+    if (event.type != CombatEventType::Hit &&
+        event.type != CombatEventType::Block)
+      continue;
+
+    if (g_showFloatingDamage && !m_headlessMode)
+      m_damageNumbers.push_back(
+          DamageNumber{event.position, event.damage + event.chipDamage, 1.0f});
+    Logger::debug(event.source == m_playerFighter ? "Player hit enemy!"
+                                                  : "Enemy hit player!");
   }
 }
 
+void Game::endFrame() {
+  static Gauge &bytes = Metrics::gauge(MetricNames::FrameArenaBytes);
+  static Counter &allocations =
+      Metrics::counter(MetricNames::FrameArenaAllocations);
+  static Counter &spills = Metrics::counter(MetricNames::FrameArenaSpills);
+
+  FrameArena &arena = FrameArena::local();
+  bytes.set(static_cast<double>(arena.frameHigh()));
+  allocations.increment(arena.allocations());
+  spills.increment(arena.spills());
+  arena.reset();
+
+  MemoryTracker::endFrame();
+}
+
 void Game::handleEnemyInput() {
   if (Input::isKeyDown(SDL_SCANCODE_D))
     m_enemy->mover.applyForce(Vector2f(-m_config.moveForce, 0));
@@ -383,6 +453,8 @@ void Game::render() {
   if (m_headlessMode)
     return;
 
+  MemoryTracker::Scope memoryScope(MemorySubsystem::Rendering);
+
   if (m_combatSystem->trainingMode()) {
     m_trainingRenderTimer += m_deltaTime;
     if (m_trainingRenderTimer < TRAINING_RENDER_INTERVAL) {
@@ -406,7 +478,7 @@ void Game::render() {
 
   ImDrawList *draw_list = ImGui::GetBackgroundDrawList();
 
-  for (auto it = g_damageEvents.begin(); it != g_damageEvents.end();) {
+  for (auto it = m_damageNumbers.begin(); it != m_damageNumbers.end();) {
 
     float screenX = offset.x + it->position.x * m_camera.scale;
     float screenY = offset.y + it->position.y * m_camera.scale;
@@ -420,7 +492,7 @@ void Game::render() {
     it->position.y -= 20.0f * m_deltaTime;
     it->timeRemaining -= m_deltaTime;
     if (it->timeRemaining <= 0)
-      it = g_damageEvents.erase(it);
+      it = m_damageNumbers.erase(it);
     else
       ++it;
   }
@@ -453,7 +525,7 @@ void Game::render() {
                      m_config.windowHeight / 2, textColor, m_zoomEffect);
 
     if (m_roundEndTimer >= 3.0f) {
-      m_combatSystem->startNewRound(*m_player, *m_enemy);
+      startNewRound();
       m_roundEnded = false;
     }
   }
@@ -489,6 +561,8 @@ void Game::renderDebugUI() {
   if (!m_showDebugUI)
     return;
 
+  MemoryTracker::Scope memoryScope(MemorySubsystem::Rendering);
+
   ImGuiWindowFlags window_flags =
       ImGuiWindowFlags_MenuBar | ImGuiWindowFlags_NoDocking;
   const ImGuiViewport *viewport = ImGui::GetMainViewport();
@@ -515,7 +589,9 @@ void Game::renderDebugUI() {
       ImGui::MenuItem("Debug Controls", nullptr, &m_showDebugWindow);
       ImGui::MenuItem("AI Debug", nullptr, &m_showAIDebug);
       ImGui::MenuItem("Performance", nullptr, &m_showPerformance);
+      ImGui::MenuItem("Memory", nullptr, &m_showMemory);
       ImGui::MenuItem("Config Editor", nullptr, &m_showConfigEditor);
+      ImGui::MenuItem("Telemetry", nullptr, &m_showTelemetry);
       ImGui::EndMenu();
     }
     ImGui::EndMenuBar();
@@ -563,9 +639,15 @@ void Game::renderDebugUI() {
   if (m_showPerformance) {
     renderPerformanceWindow();
   }
+  if (m_showMemory) {
+    renderMemoryWindow();
+  }
   if (m_showConfigEditor) {
     ConfigEditor::render(*this, m_config, m_showConfigEditor);
   }
+  if (m_showTelemetry) {
+    TelemetryPanel::render(m_showTelemetry);
+  }
 }
 
 void Game::renderPerformanceWindow() {
@@ -586,6 +668,48 @@ void Game::renderPerformanceWindow() {
   ImGui::End();
 }
 
+void Game::renderMemoryWindow() {
+  ImGui::Begin("Memory", &m_showMemory);
+
+  if (!MemoryTracker::HOOKED)
+    ImGui::TextWrapped("Only tagged resources and textures are counted; "
+                       "build with ENABLE_MEMORY_TRACKING=1 for all heap "
+                       "allocations.");
+
+  if (ImGui::BeginTable("memory", 4, ImGuiTableFlags_Borders)) {
+    ImGui::TableNextRow();
+    const char *headers[] = {"Subsystem", "Live (KiB)", "Peak (KiB)",
+                             "Allocs/frame"};
+    for (const char *header : headers) {
+      ImGui::TableNextColumn();
+      ImGui::Text("%s", header);
+    }
+
+    for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+      const auto subsystem = static_cast<MemorySubsystem>(i);
+      const MemoryTracker::Stats stats = MemoryTracker::stats(subsystem);
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text("%s", memorySubsystemName(subsystem));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", stats.liveBytes / 1024.0);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", stats.peakBytes / 1024.0);
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu",
+                  static_cast<unsigned long long>(stats.frameAllocations));
+    }
+    ImGui::EndTable();
+  }
+
+  const FrameArena &arena = FrameArena::local();
+  ImGui::Text("Frame arena: %.1f / %.1f KiB (peak %.1f KiB)",
+              arena.used() / 1024.0, arena.capacity() / 1024.0,
+              arena.peak() / 1024.0);
+
+  ImGui::End();
+}
+
 void Game::renderAIDebugWindow() {
   if (!m_showAIDebug)
     return;
@@ -600,13 +724,13 @@ void Game::renderAIDebugWindow() {
   if (ImGui::CollapsingHeader("Neural Network Visualizer")) {
     if (nnVisualizer == nullptr) {
       nnVisualizer =
-          new NeuralNetworkVisualizer(m_player_agent->onlineDQN.get());
+          new NeuralNetworkVisualizer(m_player_agent.get());
     }
     nnVisualizer->render();
   }
 
   if (ImGui::CollapsingHeader("Neural Network Tree View")) {
-    static NeuralNetworkTreeView treeView(m_player_agent->onlineDQN.get());
+    static NeuralNetworkTreeView treeView(m_player_agent.get());
     treeView.render();
   }
 
@@ -703,8 +827,41 @@ void Game::renderAIDebugWindow() {
             ImGui::EndTable();
 
             if (ImGui::Button("Reset Agent")) {
-              agent->reset();
+              const Character &opponent =
+                  agent == m_player_agent.get() ? *m_enemy : *m_player;
+              agent->reset(opponent);
+              agent->clearReplayBuffer();
+            }
+
+            bool quantized = agent->usesQuantizedInference();
+            if (ImGui::Checkbox("Int8 Inference", &quantized))
+              agent->setQuantizedInference(quantized);
+            if (ImGui::IsItemHovered()) {
+              ImGui::SetTooltip("Run the policy on an int8 copy of the "
+                                "network. Learning is paused while enabled.");
             }
+            if (quantized) {
+              const QuantizationReport &report =
+                  agent->getQuantizationReport();
+              ImGui::Text("Agreement: %.1f%% (%zu states), max |dQ| %.4f",
+                          report.agreementRate() * 100.0f, report.samples,
+                          report.maxAbsError);
+            }
+
+            std::string checkpointPath = std::string(charId) + ".ckpt";
+            if (ImGui::Button("Save Checkpoint"))
+              agent->saveCheckpoint(checkpointPath);
+            ImGui::SameLine();
+            if (ImGui::Button("Load Checkpoint"))
+              agent->loadCheckpoint(checkpointPath);
+            ImGui::SameLine();
+            if (ImGui::Button("Resume Latest"))
+              agent->resumeLatestCheckpoint();
+            if (const CheckpointScheduler *scheduler =
+                    agent->checkpointScheduler())
+              ImGui::Text("Auto checkpoints written: %llu",
+                          static_cast<unsigned long long>(
+                              scheduler->written()));
 
             ImGui::Separator();
             static std::unordered_map<std::string, std::vector<float>>
@@ -851,6 +1008,11 @@ void Game::setRoundEnd(const std::string &winnerText) {
   m_zoomEffect = 1.0f;
 }
 
+void Game::startNewRound() {
+  m_combatSystem->startNewRound(*m_player, *m_enemy);
+  m_fightSystem.resetRound();
+}
+
 void Game::updateScreenEffects(float deltaTime) {
 
   m_screenShake.update(deltaTime);
@@ -3,10 +3,13 @@
 #include "Core/Config.hpp"
 #include "Core/GuiContext.hpp"
 #include "Core/SDLContext.hpp"
+#include "Game/BroadPhase.hpp"
 #include "Game/Character.hpp"
 #include "Game/CharacterControl.hpp"
+#include "Game/CombatEvents.hpp"
 #include "Game/CombatSystem.hpp"
 #include "Game/FightSystem.hpp"
+#include "Game/FighterPool.hpp"
 #include "Rendering/Renderer.hpp"
 #include "Rendering/Text.hpp"
 #include "Rendering/VFX.hpp"
@@ -49,11 +52,17 @@ private:
   void updateCharacterControl(CharacterControl &control, RLAgent *agent,
                               Character *character);
   void handleEnemyInput();
+  // Runs the reward, VFX and telemetry stages over this tick's events.
+  void dispatchCombatEvents(const CombatEventQueue &events);
+  // Closes the frame: publishes the arena's usage and releases it, and
+  // latches the per-frame allocation counts.
+  void endFrame();
 
   void render();
   void renderBackground();
   void renderDebugUI();
   void renderPerformanceWindow();
+  void renderMemoryWindow();
   void renderAIDebugWindow();
   void renderConfigEditor();
   void renderTrainingOverlay();
@@ -63,6 +72,9 @@ private:
   void triggerSlowMotion(float duration, float timeScale);
 
   void setRoundEnd(const std::string &winnerText);
+  // Restores the round template and drops the fight system's per-round
+  // state with it.
+  void startNewRound();
 
   Config m_config;
 
@@ -72,6 +84,8 @@ private:
   std::unique_ptr<ResourceManager> m_resourceManager;
   std::shared_ptr<Texture2D> m_backgroundTexture;
 
+  // Declared before the animators and characters that view its slots.
+  FighterPool m_fighterPool{MAX_FIGHTERS};
   std::unique_ptr<Animator> m_animatorPlayer;
   std::unique_ptr<Animator> m_animatorEnemy;
   std::unique_ptr<Character> m_player;
@@ -97,20 +111,29 @@ private:
   bool m_headlessMode = false;
   bool m_showDebugWindow = true;
   bool m_showPerformance = true;
+  bool m_showMemory = false;
   bool m_showAIDebug = true;
   bool m_showDebugUI = false;
   bool m_showGameView = true;
   bool m_showConfigEditor = true;
+  bool m_showTelemetry = false;
   bool m_paused = false;
 
   float m_trainingRenderTimer = 0.0f;
   const float TRAINING_RENDER_INTERVAL = 0.1f;
 
   FightSystem m_fightSystem;
+  int m_playerFighter = 0;
+  int m_enemyFighter = 1;
+  // Body-vs-body pushing; hit detection has its own in FightSystem.
+  BroadPhase m_bodyPhase;
   Camera m_camera;
   ScreenShake m_screenShake;
   SlowMotion m_slowMotion;
+  std::vector<DamageNumber> m_damageNumbers;
 
+  // Fighter slots for this process; one match uses two.
+  static constexpr size_t MAX_FIGHTERS = 2;
   static constexpr int MAX_TRAINING_STEPS_PER_FRAME = 10;
   static constexpr float TRAINING_TIME_STEP = 1.0f / 60.0f;
 
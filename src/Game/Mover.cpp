@@ -1,8 +1,11 @@
 #include "Mover.hpp"
+#include "Game/FighterPool.hpp"
 
-Mover::Mover()
-    : position(0, 0), velocity(0, 0), acceleration(0, 0), mass(1.0f),
-      friction(2.0f) {}
+Mover::Mover(FighterPool &pool, int index)
+    : position(pool.positionX[index], pool.positionY[index]),
+      velocity(pool.velocityX[index], pool.velocityY[index]),
+      acceleration(pool.accelerationX[index], pool.accelerationY[index]),
+      mass(pool.mass[index]), friction(pool.friction[index]) {}
 
 void Mover::update(float deltaTime) {
 
@@ -2,15 +2,20 @@
 
 #include "Data/Vector2f.hpp"
 
+class FighterPool;
+
+// A fighter's motion state, viewed in place in its FighterPool slot.
+// FighterPool::step() integrates every fighter at once; update() is the same
+// step for this one.
 class Mover {
 public:
-  Vector2f position;
-  Vector2f velocity;
-  Vector2f acceleration;
-  float mass;
-  float friction;
+  Vector2fRef position;
+  Vector2fRef velocity;
+  Vector2fRef acceleration;
+  float &mass;
+  float &friction;
 
-  Mover();
+  Mover(FighterPool &pool, int index);
 
   void applyForce(const Vector2f &force);
 
@@ -4,104 +4,116 @@
 #include "Data/Animation.hpp"
 #include <utility>
 
-Animator::Animator(SDL_Texture *texture)
-    : m_texture(texture), m_currentFrameIndex(0), m_timer(0.0f), m_flip(false),
-      m_reverse(false) {}
+Animator::Animator(SDL_Texture *texture) : m_texture(texture) {}
 
 Animator::Animator(SDL_Texture *texture,
                    const std::map<std::string, Animation> &animations)
-    : m_texture(texture), m_animations(animations), m_currentFrameIndex(0),
-      m_timer(0.0f), m_flip(false), m_reverse(false) {}
+    : m_texture(texture), m_animations(animations) {
+  int id = 0;
+  for (auto &entry : m_animations) {
+    entry.second.id = id++;
+    entry.second.buildHitboxTable();
+  }
+}
 
 void Animator::addAnimation(const std::string &key, const Animation &anim) {
-  m_animations.emplace(key, anim);
+  auto inserted = m_animations.emplace(key, anim);
+  if (inserted.second) {
+    inserted.first->second.id = static_cast<int>(m_animations.size()) - 1;
+    inserted.first->second.buildHitboxTable();
+  }
+}
+
+void Animator::attach(AnimationPlayback &slot) {
+  slot = *m_playback;
+  m_playback = &slot;
+}
+
+const Animation &Animator::current() const {
+  static const Animation empty{};
+  return m_playback->animation ? *m_playback->animation : empty;
 }
 
 void Animator::play(const std::string &key) {
-  if (m_currentKey == key && !m_completedOnce) {
+  AnimationPlayback &playback = *m_playback;
+  if (m_currentKey && *m_currentKey == key && !playback.completedOnce) {
     return;
   }
 
   auto it = m_animations.find(key);
   if (it != m_animations.end()) {
-    m_currentKey = key;
-    m_currentAnimation = it->second;
-    m_currentFrameIndex =
-        m_reverse ? (m_currentAnimation.frames.size() - 1) : 0;
-    m_timer = 0.0f;
-    m_completedOnce = false;
-    Logger::debug("Playing animation: " + key +
-                  (m_reverse ? " (reverse)" : ""));
+    m_currentKey = &it->first;
+    playback.animation = &it->second;
+    playback.frame = playback.reverse ? (it->second.frames.size() - 1) : 0;
+    playback.timer = 0.0f;
+    playback.completedOnce = false;
+    Logger::debug("Playing animation: %s%s", key.c_str(),
+                  playback.reverse ? " (reverse)" : "");
   }
 }
 
 void Animator::update(float deltaTime) {
-  if (m_currentAnimation.frames.empty()) {
+  if (current().frames.empty()) {
     return;
   }
+  advance(*m_playback, deltaTime);
+
+  Logger::debug("Animation State:");
+  Logger::debug("  Current Key: %s", getCurrentAnimationKey().c_str());
+  Logger::debug("  Frame Index: %d", m_playback->frame);
+  Logger::debug("  Timer: %f", m_playback->timer);
+  Logger::debug("  Phase: %s", frame_phase_to_string(getCurrentFramePhase()));
+  Logger::debug("  Completed Once: %s",
+                m_playback->completedOnce ? "true" : "false");
+}
 
-  m_timer += deltaTime * 1000.0f;
+void Animator::advance(AnimationPlayback &playback, float deltaTime) {
+  if (!playback.animation || playback.animation->frames.empty())
+    return;
+  const Animation &animation = *playback.animation;
+  const int last = static_cast<int>(animation.frames.size()) - 1;
 
-  while (m_timer >=
-         m_currentAnimation.frames[m_currentFrameIndex].duration_ms) {
-    m_timer -= m_currentAnimation.frames[m_currentFrameIndex].duration_ms;
+  playback.timer += deltaTime * 1000.0f;
 
-    if (!m_reverse) {
-      m_currentFrameIndex++;
-      if (m_currentFrameIndex >=
-          static_cast<int>(m_currentAnimation.frames.size())) {
-        if (m_currentAnimation.loop) {
-          m_currentFrameIndex = 0;
+  while (playback.timer >= animation.frames[playback.frame].duration_ms) {
+    playback.timer -= animation.frames[playback.frame].duration_ms;
 
-          m_completedOnce = true;
-        } else {
-          m_currentFrameIndex = m_currentAnimation.frames.size() - 1;
-          m_completedOnce = true;
-        }
+    if (!playback.reverse) {
+      playback.frame++;
+      if (playback.frame > last) {
+        playback.frame = animation.loop ? 0 : last;
+        playback.completedOnce = true;
       }
     } else {
-      m_currentFrameIndex--;
-      if (m_currentFrameIndex < 0) {
-        if (m_currentAnimation.loop) {
-          m_currentFrameIndex = m_currentAnimation.frames.size() - 1;
-          m_completedOnce = true;
-        } else {
-          m_currentFrameIndex = 0;
-          m_completedOnce = true;
-        }
+      playback.frame--;
+      if (playback.frame < 0) {
+        playback.frame = animation.loop ? last : 0;
+        playback.completedOnce = true;
       }
     }
   }
-
-  Logger::debug("Animation State:");
-  Logger::debug("  Current Key: " + m_currentKey);
-  Logger::debug("  Frame Index: " + std::to_string(m_currentFrameIndex));
-  Logger::debug("  Timer: " + std::to_string(m_timer));
-  Logger::debug("  Phase: " +
-                std::string(frame_phase_to_string(getCurrentFramePhase())));
-  Logger::debug("  Completed Once: " +
-                std::string(m_completedOnce ? "true" : "false"));
 }
 
 void Animator::render(SDL_Renderer *renderer, int x, int y, float scale) {
-  if (m_currentAnimation.frames.empty())
+  if (current().frames.empty())
     return;
 
-  const Frame &frame = m_currentAnimation.frames[m_currentFrameIndex];
+  const Frame &frame = current().frames[m_playback->frame];
   SDL_Rect dest;
   dest.x = x;
   dest.y = y;
   dest.w = static_cast<int>(frame.frameRect.w * scale);
   dest.h = static_cast<int>(frame.frameRect.h * scale);
 
-  SDL_RendererFlip flip = m_flip ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
+  SDL_RendererFlip flip =
+      m_playback->flip ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
   SDL_RenderCopyEx(renderer, m_texture, &frame.frameRect, &dest, 0.0, nullptr,
                    flip);
 
   for (const auto &hitbox : frame.hitboxes) {
     if (g_showDebugOverlay && hitbox.enabled) {
       SDL_Rect hitRect;
-      if (m_flip) {
+      if (m_playback->flip) {
 
         hitRect.x =
             x + static_cast<int>((frame.frameRect.w - (hitbox.x + hitbox.w)) *
@@ -133,38 +145,44 @@ void Animator::render(SDL_Renderer *renderer, int x, int y, float scale) {
 }
 
 const std::vector<Hitbox> &Animator::getCurrentHitboxes() const {
-  if (m_currentAnimation.frames.empty()) {
+  if (current().frames.empty()) {
     static std::vector<Hitbox> empty;
     return empty;
   }
-  return m_currentAnimation.frames[m_currentFrameIndex].hitboxes;
+  return current().frames[m_playback->frame].hitboxes;
+}
+
+SDL_Rect Animator::getCurrentHitboxBounds(HitboxType type) const {
+  if (current().frames.empty())
+    return SDL_Rect{0, 0, 0, 0};
+  return current().hitboxes.bounds(m_playback->frame, type, m_playback->flip);
 }
 
 SDL_Rect Animator::getCurrentFrameRect() const {
-  if (m_currentAnimation.frames.empty())
+  if (current().frames.empty())
     return SDL_Rect{0, 0, 0, 0};
-  return m_currentAnimation.frames[m_currentFrameIndex].frameRect;
+  return current().frames[m_playback->frame].frameRect;
 }
 
 FramePhase Animator::getCurrentFramePhase() const {
-  if (m_currentAnimation.frames.empty())
+  if (current().frames.empty())
     return FramePhase::None;
-  return m_currentAnimation.frames[m_currentFrameIndex].phase;
+  return current().frames[m_playback->frame].phase;
 }
 
 bool Animator::isAnimationFinished() const {
-  Logger::debug("ANIMATION FINISHED: " + m_currentAnimation.name);
-  if (!m_currentAnimation.loop && !m_currentAnimation.frames.empty() &&
-      m_currentFrameIndex ==
-          static_cast<int>(m_currentAnimation.frames.size()) - 1) {
+  const Animation &animation = current();
+  Logger::debug("ANIMATION FINISHED: %s", animation.name.c_str());
+  if (!animation.loop && !animation.frames.empty() &&
+      m_playback->frame == static_cast<int>(animation.frames.size()) - 1) {
     return true;
   }
   return false;
 }
 
-std::string Animator::getCurrentAnimationKey() const { return m_currentKey; }
-Animation &Animator::getAnimation(const std::string &name) {
-  return m_animations[name];
+const std::string &Animator::getCurrentAnimationKey() const {
+  static const std::string none;
+  return m_currentKey ? *m_currentKey : none;
 }
 
 bool Animator::hasAnimation(const std::string &name) {
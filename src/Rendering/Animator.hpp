@@ -6,6 +6,18 @@
 #include <string>
 #include <vector>
 
+// Playback state of one Animator. It lives in the Animator until attach()
+// moves it into a FighterPool slot, where FighterPool::animate() steps every
+// fighter's playback in one pass.
+struct AnimationPlayback {
+  const Animation *animation = nullptr; // Null before the first play()
+  int frame = 0;
+  float timer = 0.0f; // Milliseconds into the current frame
+  bool flip = false;
+  bool reverse = false;
+  bool completedOnce = false;
+};
+
 class Animator {
 public:
   // Construct an Animator using a spritesheet texture.
@@ -16,14 +28,38 @@ public:
   Animator(SDL_Texture *texture,
            const std::map<std::string, Animation> &animations);
 
+  // The playback state may be moved into external storage, so copies would
+  // share it.
+  Animator(const Animator &) = delete;
+  Animator &operator=(const Animator &) = delete;
+
+  // Move the playback state into `slot` (e.g. a FighterPool column) and use
+  // it from now on. `slot` must outlive the Animator.
+  void attach(AnimationPlayback &slot);
+
   // Add an animation with a key.
   void addAnimation(const std::string &key, const Animation &anim);
 
   // Play (switch to) the animation identified by key.
   void play(const std::string &key);
 
+  // The current animation and its playback. restore() returns to it without
+  // looking the key up again; the snapshot stays valid for the Animator's
+  // lifetime.
+  struct Snapshot {
+    AnimationPlayback playback;
+    const std::string *key = nullptr;
+  };
+  Snapshot snapshot() const { return Snapshot{*m_playback, m_currentKey}; }
+  void restore(const Snapshot &snapshot) {
+    *m_playback = snapshot.playback;
+    m_currentKey = snapshot.key;
+  }
+
   // Update the animation timer (deltaTime in seconds).
   void update(float deltaTime);
+  // The frame stepping behind update(), without the debug logging.
+  static void advance(AnimationPlayback &playback, float deltaTime);
 
   // Render the current frame at the given screen position, scaled by 'scale'.
   void render(SDL_Renderer *renderer, int x, int y, float scale);
@@ -31,40 +67,50 @@ public:
   // Retrieve current hitboxes.
   const std::vector<Hitbox> &getCurrentHitboxes() const;
 
+  // Precomputed hitboxes of the current animation (see HitboxTable), and the
+  // union of the current frame's boxes of `type` for the current facing,
+  // relative to the frame.
+  const HitboxTable &getHitboxTable() const { return current().hitboxes; }
+  SDL_Rect getCurrentHitboxBounds(HitboxType type) const;
+  int getCurrentFrameIndex() const { return m_playback->frame; }
+
   // Get the current frame’s rectangle.
   SDL_Rect getCurrentFrameRect() const;
 
   FramePhase getCurrentFramePhase() const;
 
-  Animation &getAnimation(const std::string &name);
-
   bool hasAnimation(const std::string &name);
 
   // Set whether to flip the sprite horizontally.
-  void setFlip(bool flip) { m_flip = flip; }
-  bool getFlip() const { return m_flip; }
+  void setFlip(bool flip) { m_playback->flip = flip; }
+  bool getFlip() const { return m_playback->flip; }
 
   // Set whether the animation should play in reverse.
-  void setReverse(bool reverse) { m_reverse = reverse; }
-  bool getReverse() const { return m_reverse; }
+  void setReverse(bool reverse) { m_playback->reverse = reverse; }
+  bool getReverse() const { return m_playback->reverse; }
 
   bool isAnimationFinished() const;
 
-  std::string getCurrentAnimationKey() const;
+  // Empty before the first play(). A reference into the animation table, so
+  // comparing it against a key does not allocate.
+  const std::string &getCurrentAnimationKey() const;
+  // Stable small integer for the playing animation (-1 before play()), for
+  // comparisons that should not copy the key.
+  int getCurrentAnimationId() const { return current().id; }
 
   void setFrameIndex(int index) {
-    m_currentFrameIndex = index;
-    m_timer = 0.0f;
+    m_playback->frame = index;
+    m_playback->timer = 0.0f;
   }
 
 private:
   SDL_Texture *m_texture;
   std::map<std::string, Animation> m_animations;
-  Animation m_currentAnimation;
-  std::string m_currentKey;
-  int m_currentFrameIndex;
-  float m_timer;
-  bool m_flip;
-  bool m_reverse;
-  bool m_completedOnce = false;
+  // m_currentKey and m_playback->animation point into m_animations, whose
+  // nodes never move.
+  const std::string *m_currentKey = nullptr;
+  AnimationPlayback m_ownPlayback;
+  AnimationPlayback *m_playback = &m_ownPlayback;
+
+  const Animation &current() const;
 };
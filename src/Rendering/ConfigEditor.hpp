@@ -147,6 +147,26 @@ public:
         ImGui::DragFloat("Well Timed Block Bonus",
                          &config.ai.wellTimedBlockBonus, 0.1f, 0.0f, 50.0f);
 
+        ImGui::Spacing();
+        ImGui::Text("Replay & Target Network");
+        ImGui::Separator();
+        ImGui::SliderInt("Update Interval", &config.ai.targetUpdateInterval,
+                         1, 100);
+        ImGui::SliderInt("N-Step Returns", &config.ai.nStepReturns, 1, 10);
+        ImGui::SliderInt("Priority Refresh Batch",
+                         &config.ai.priorityRefreshBatch, 0, 256);
+
+        ImGui::Spacing();
+        ImGui::Text("Opponent Model");
+        ImGui::Separator();
+        ImGui::DragFloat("Count Decay", &config.ai.opponentModelDecay, 0.0001f,
+                         0.99f, 1.0f, "%.4f");
+
+        ImGui::Spacing();
+        ImGui::Text("Checkpoints");
+        ImGui::Separator();
+        ImGui::Checkbox("Auto Checkpoint", &config.ai.autoCheckpoint);
+
         ImGui::EndTabItem();
       }
 
@@ -2,7 +2,7 @@
 #include "Game/Character.hpp"
 #include "Rendering/Text.hpp"
 #include <SDL.h>
-#include <sstream>
+#include <cstdio>
 
 class DebugOverlay {
 public:
@@ -12,16 +12,18 @@ public:
     Vector2f screenPos =
         worldToScreen(character.mover.position, camera, config);
 
-    std::stringstream ss;
-    ss << "Pos: (" << (int)character.mover.position.x << ", "
-       << (int)character.mover.position.y << ")\n"
-       << "Health: " << character.health << "/" << character.maxHealth << "\n"
-       << "Stamina: " << (int)character.stamina << "\n"
-       << "Animation: " << character.animator->getCurrentAnimationKey() << "\n"
-       << "Combo: " << character.comboCount;
+    char text[256];
+    std::snprintf(text, sizeof(text),
+                  "Pos: (%d, %d)\nHealth: %d/%d\nStamina: %d\n"
+                  "Animation: %s\nCombo: %d",
+                  (int)character.mover.position.x,
+                  (int)character.mover.position.y, character.health,
+                  character.maxHealth, (int)character.stamina,
+                  character.animator->getCurrentAnimationKey().c_str(),
+                  character.comboCount);
 
     SDL_Color textColor = {255, 255, 255, 255};
-    drawText(renderer, ss.str(), (int)screenPos.x + 50, (int)screenPos.y - 80,
+    drawText(renderer, text, (int)screenPos.x + 50, (int)screenPos.y - 80,
              textColor);
   }
 
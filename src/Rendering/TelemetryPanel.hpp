@@ -0,0 +1,91 @@
+#pragma once
+#include "Core/Metrics.hpp"
+#include "imgui.h"
+#include <algorithm>
+#include <string>
+
+class TelemetryPanel {
+public:
+  static void render(bool &show) {
+    if (!show)
+      return;
+
+    ImGui::Begin("Training Telemetry", &show);
+
+    renderRecordingControls();
+
+    if (ImGui::CollapsingHeader("Throughput (per second)",
+                                ImGuiTreeNodeFlags_DefaultOpen)) {
+      for (const auto &series : Metrics::rateSeries())
+        plotSeries(series, "%.1f/s");
+    }
+
+    if (ImGui::CollapsingHeader("Gauges", ImGuiTreeNodeFlags_DefaultOpen)) {
+      for (const auto &series : Metrics::gaugeSeries())
+        plotSeries(series, "%.3f");
+    }
+
+    if (ImGui::CollapsingHeader("Distributions",
+                                ImGuiTreeNodeFlags_DefaultOpen)) {
+      if (ImGui::BeginTable("histograms", 6, ImGuiTableFlags_Borders)) {
+        ImGui::TableNextRow();
+        const char *headers[] = {"Metric", "Count", "Mean",
+                                 "p50",    "p99",   "Max"};
+        for (const char *header : headers) {
+          ImGui::TableNextColumn();
+          ImGui::Text("%s", header);
+        }
+
+        for (const auto &entry : Metrics::histograms()) {
+          const Histogram &h = *entry.second;
+          ImGui::TableNextRow();
+          ImGui::TableNextColumn();
+          ImGui::Text("%s", entry.first.c_str());
+          ImGui::TableNextColumn();
+          ImGui::Text("%llu", static_cast<unsigned long long>(h.count()));
+          ImGui::TableNextColumn();
+          ImGui::Text("%.2f", h.mean());
+          ImGui::TableNextColumn();
+          ImGui::Text("%.2f", h.quantile(0.5));
+          ImGui::TableNextColumn();
+          ImGui::Text("%.2f", h.quantile(0.99));
+          ImGui::TableNextColumn();
+          ImGui::Text("%.2f", h.count() ? h.max() : 0.0);
+        }
+        ImGui::EndTable();
+      }
+    }
+
+    ImGui::End();
+  }
+
+private:
+  static void plotSeries(const Metrics::Series &series, const char *format) {
+    auto bounds =
+        std::minmax_element(series.history.begin(), series.history.end());
+    char overlay[64];
+    snprintf(overlay, sizeof(overlay), format, series.latest);
+    ImGui::PlotLines(series.name.c_str(), series.history.data(),
+                     static_cast<int>(series.history.size()),
+                     static_cast<int>(series.offset), overlay, *bounds.first,
+                     *bounds.second, ImVec2(0, 40));
+  }
+
+  static void renderRecordingControls() {
+    static int format = 0;
+    if (Metrics::isRecording()) {
+      ImGui::Text("Recording to %s", Metrics::recordingPath().c_str());
+      if (ImGui::Button("Stop Recording"))
+        Metrics::stopRecording();
+      return;
+    }
+
+    ImGui::Combo("Format", &format, "CSV\0Binary\0");
+    if (ImGui::Button("Record Metrics")) {
+      bool binary = format == 1;
+      Metrics::startRecording(binary ? "metrics.bin" : "metrics.csv",
+                              binary ? MetricsFormat::Binary
+                                     : MetricsFormat::Csv);
+    }
+  }
+};
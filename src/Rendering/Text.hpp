@@ -4,13 +4,13 @@
 #include <SDL_ttf.h>
 #include <string>
 
-inline static void drawText(SDL_Renderer *renderer, const std::string &text,
-                            int x, int y, SDL_Color color, int fontSize = 14) {
+inline static void drawText(SDL_Renderer *renderer, const char *text, int x,
+                            int y, SDL_Color color, int fontSize = 14) {
   TTF_Font *font = TTF_OpenFont(R::font("seguiemj.ttf").c_str(), fontSize);
   if (!font)
     return;
   SDL_Surface *surface =
-      TTF_RenderText_Blended_Wrapped(font, text.c_str(), color, 1000);
+      TTF_RenderText_Blended_Wrapped(font, text, color, 1000);
   if (!surface) {
     TTF_CloseFont(font);
     return;
@@ -23,6 +23,11 @@ inline static void drawText(SDL_Renderer *renderer, const std::string &text,
   TTF_CloseFont(font);
 }
 
+inline static void drawText(SDL_Renderer *renderer, const std::string &text,
+                            int x, int y, SDL_Color color, int fontSize = 14) {
+  drawText(renderer, text.c_str(), x, y, color, fontSize);
+}
+
 inline static void drawCenteredText(SDL_Renderer *renderer,
                                     const std::string &text, int centerX,
                                     int centerY, SDL_Color color, float scale) {
@@ -1,4 +1,5 @@
 #pragma once
+#include "Core/MemoryTracker.hpp"
 #include <SDL.h>
 #include <SDL_image.h>
 #include <memory>
@@ -21,12 +22,21 @@ public:
                                std::string(IMG_GetError()));
     }
     SDL_QueryTexture(m_texture.get(), nullptr, nullptr, &m_width, &m_height);
+    MemoryTracker::recordAllocation(MemorySubsystem::Resources, pixelBytes());
   }
+  ~Texture2D() {
+    MemoryTracker::recordDeallocation(MemorySubsystem::Resources,
+                                      pixelBytes());
+  }
+
   SDL_Texture *get() const { return m_texture.get(); }
   int width() const { return m_width; }
   int height() const { return m_height; }
 
 private:
+  // Decoded RGBA size, whatever the renderer actually stores.
+  size_t pixelBytes() const { return size_t(m_width) * size_t(m_height) * 4; }
+
   std::unique_ptr<SDL_Texture, SDLTextureDeleter> m_texture;
   int m_width, m_height;
 };
@@ -20,6 +20,13 @@ struct ScreenShake {
   }
 };
 
+// Floating damage number, drifting up and fading over timeRemaining.
+struct DamageNumber {
+  Vector2f position;
+  int damage;
+  float timeRemaining;
+};
+
 struct SlowMotion {
   float duration;
   float timeScale;
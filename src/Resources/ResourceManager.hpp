@@ -1,4 +1,5 @@
 #pragma once
+#include "Core/MemoryTracker.hpp"
 #include "Rendering/Texture2D.hpp"
 #include <memory>
 #include <string>
@@ -11,6 +12,7 @@ public:
   std::shared_ptr<Texture2D> getTexture(const std::string &filePath) {
     if (m_textures.find(filePath) != m_textures.end())
       return m_textures[filePath];
+    MemoryTracker::Scope memoryScope(MemorySubsystem::Resources);
     auto texture = std::make_shared<Texture2D>(m_renderer, filePath);
     m_textures[filePath] = texture;
     return texture;